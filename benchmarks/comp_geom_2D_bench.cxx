@@ -0,0 +1,266 @@
+// Google Benchmark suite for comp_geom_2D.
+//
+// Build from the repository root (needs Google Benchmark installed):
+//
+//   g++ -std=c++17 -O2 -DNDEBUG benchmarks/comp_geom_2D_bench.cxx -lbenchmark -lpthread -o comp_geom_2D_bench
+//
+// Every algorithm is registered for each coordinate type (int, long long,
+// float, double) and input distribution (uniform, gaussian, circle, clustered)
+// at sizes 1e2, 1e3, ... up to CG_BENCH_MAX_N. Inputs are generated before the
+// timed loop with a fixed seed. Each run reports items_per_second (points,
+// or point-edge tests for isInside) and allocs_per_call, counted by the
+// replacement operator new below.
+//
+// The default CG_BENCH_MAX_N = 1e6 keeps a full run to minutes. Add
+// -DCG_BENCH_MAX_N=100000000 for the 1e8 sizes, which need several GB of
+// memory for closestPair, and select with --benchmark_filter, e.g.
+//   ./comp_geom_2D_bench --benchmark_filter='convexHull<double>/circle'
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "../comp_geom_2D.cxx"
+
+#ifndef CG_BENCH_MAX_N
+#define CG_BENCH_MAX_N 1000000
+#endif
+
+// Allocation counting for allocs_per_call. Relaxed increments keep the
+// overhead to one uncontended atomic add per allocation. GCC cannot see that
+// new and delete are replaced as a pair and warns about free().
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+static std::atomic<size_t> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, std::align_val_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t a = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+enum class Distribution { Uniform, Gaussian, Circle, Clustered };
+
+const char* name(Distribution d) {
+    switch (d) {
+    case Distribution::Uniform: return "uniform";
+    case Distribution::Gaussian: return "gaussian";
+    case Distribution::Circle: return "circle";
+    default: return "clustered";
+    }
+}
+
+template <typename T> const char* typeName();
+template <> const char* typeName<int>() { return "int"; }
+template <> const char* typeName<long long>() { return "long long"; }
+template <> const char* typeName<float>() { return "float"; }
+template <> const char* typeName<double>() { return "double"; }
+
+// Coordinates span about +-1e6 for every type, so integer inputs round to a
+// fine grid and the circle distribution is every hull's worst case: all
+// points are hull vertices (up to rounding for integers).
+template <typename T>
+std::vector<Point<T>> generate(Distribution d, size_t n, uint32_t seed = 42) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uni(-1e6, 1e6);
+    std::normal_distribution<double> gauss(0.0, 2.5e5);
+    std::uniform_real_distribution<double> angle(0.0, 2 * std::acos(-1.0));
+    std::vector<Point<double>> centers(64);
+    for (auto& c : centers) c = Point<double>(uni(rng) * 0.9, uni(rng) * 0.9);
+    std::normal_distribution<double> spread(0.0, 1e4);
+
+    std::vector<Point<T>> pts(n);
+    for (auto& p : pts) {
+        double x, y;
+        switch (d) {
+        case Distribution::Uniform: x = uni(rng); y = uni(rng); break;
+        case Distribution::Gaussian: x = gauss(rng); y = gauss(rng); break;
+        case Distribution::Circle: {
+            double a = angle(rng);
+            x = 1e6 * std::cos(a);
+            y = 1e6 * std::sin(a);
+            break;
+        }
+        default: {
+            const Point<double>& c = centers[rng() % centers.size()];
+            x = c.x + spread(rng);
+            y = c.y + spread(rng);
+        }
+        }
+        if constexpr (std::is_integral<T>::value) p = Point<T>((T)std::lround(x), (T)std::lround(y));
+        else p = Point<T>((T)x, (T)y);
+    }
+    return pts;
+}
+
+// A simple polygon through all the points: sorted by angle around their mean,
+// which makes it star-shaped.
+template <typename T>
+std::vector<Point<T>> starPolygon(std::vector<Point<T>> pts) {
+    double cx = 0, cy = 0;
+    for (const auto& p : pts) { cx += p.x; cy += p.y; }
+    cx /= pts.size();
+    cy /= pts.size();
+    std::sort(pts.begin(), pts.end(), [&](const Point<T>& a, const Point<T>& b) {
+        return std::atan2(a.y - cy, a.x - cx) < std::atan2(b.y - cy, b.x - cx);
+    });
+    return pts;
+}
+
+// Common reporting: items processed per second and allocations per iteration.
+struct Report {
+    benchmark::State& state;
+    size_t start = allocations.load();
+    explicit Report(benchmark::State& s) : state(s) {}
+    void finish(size_t itemsPerCall) {
+        state.SetItemsProcessed((int64_t)(state.iterations() * itemsPerCall));
+        state.counters["allocs_per_call"] = benchmark::Counter(double(allocations.load() - start), benchmark::Counter::kAvgIterations);
+    }
+};
+
+template <typename T>
+void orientationBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto pts = generate<T>(d, n);
+    Point<T> a(-1000, -1000), b(1000, 1000);
+    Report report(state);
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& p : pts) sum += G::orientation(a, b, p);
+        benchmark::DoNotOptimize(sum);
+    }
+    report.finish(n);
+}
+
+template <typename T>
+void doIntersectBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto pts = generate<T>(d, n + 3);
+    Report report(state);
+    for (auto _ : state) {
+        int hits = 0;
+        for (size_t i = 0; i < n; ++i) hits += G::doIntersect(pts[i], pts[i + 1], pts[i + 2], pts[i + 3]);
+        benchmark::DoNotOptimize(hits);
+    }
+    report.finish(n);
+}
+
+template <typename T>
+void convexHullBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto pts = generate<T>(d, n);
+    G::HullScratch<T> scratch;
+    Report report(state);
+    for (auto _ : state) {
+        scratch.hull.clear();
+        G::convexHull(pts.data(), n, scratch, std::back_inserter(scratch.hull));
+        benchmark::DoNotOptimize(scratch.hull.data());
+    }
+    report.finish(n);
+    state.counters["hull"] = (double)scratch.hull.size();
+}
+
+// A fixed batch of queries against an n-vertex polygon; items are
+// point-edge tests.
+template <typename T>
+void isInsideBench(benchmark::State& state, Distribution d) {
+    constexpr size_t Queries = 64;
+    size_t n = state.range(0);
+    auto polygon = starPolygon(generate<T>(d, n));
+    auto queries = generate<T>(Distribution::Uniform, Queries, 7);
+    Report report(state);
+    for (auto _ : state) {
+        int inside = 0;
+        for (const auto& q : queries) inside += G::isInside(polygon, q);
+        benchmark::DoNotOptimize(inside);
+    }
+    report.finish(n * Queries);
+}
+
+template <typename T>
+void polygonAreaBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto polygon = starPolygon(generate<T>(d, n));
+    Report report(state);
+    for (auto _ : state) benchmark::DoNotOptimize(G::polygonArea(polygon));
+    report.finish(n);
+}
+
+template <typename T>
+void closestPairBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto pts = generate<T>(d, n);
+    G::ClosestPairScratch<T> scratch;
+    Report report(state);
+    for (auto _ : state) benchmark::DoNotOptimize(G::closestPair(pts, scratch));
+    report.finish(n);
+}
+
+template <typename T>
+void polygonDiameterBench(benchmark::State& state, Distribution d) {
+    size_t n = state.range(0);
+    auto pts = generate<T>(d, n);
+    G::HullScratch<T> scratch;
+    Report report(state);
+    for (auto _ : state) benchmark::DoNotOptimize(G::polygonDiameter(pts, scratch));
+    report.finish(n);
+}
+
+template <typename T>
+void registerType() {
+    using Bench = void (*)(benchmark::State&, Distribution);
+    const std::pair<const char*, Bench> benches[] = {
+        {"orientation", orientationBench<T>},   {"doIntersect", doIntersectBench<T>},
+        {"convexHull", convexHullBench<T>},     {"isInside", isInsideBench<T>},
+        {"polygonArea", polygonAreaBench<T>},   {"closestPair", closestPairBench<T>},
+        {"polygonDiameter", polygonDiameterBench<T>},
+    };
+    for (const auto& [bench, fn] : benches) {
+        for (Distribution d : {Distribution::Uniform, Distribution::Gaussian, Distribution::Circle, Distribution::Clustered}) {
+            std::string label = std::string(bench) + "<" + typeName<T>() + ">/" + name(d);
+            auto* b = benchmark::RegisterBenchmark(label.c_str(), fn, d);
+            b->RangeMultiplier(10)->Range(100, CG_BENCH_MAX_N)->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    registerType<int>();
+    registerType<long long>();
+    registerType<float>();
+    registerType<double>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -6,8 +6,70 @@
 #include <cmath>
 #include <limits>
 #include <iomanip>
+#include <new>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <cstdio>
+#include <charconv>
+#include <memory_resource>
+
+// Batch kernels use hand-written SIMD paths selected at runtime. Define
+// COMP_GEOM_2D_NO_SIMD to build the scalar fallback only.
+#if !defined(COMP_GEOM_2D_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define COMP_GEOM_2D_X86_SIMD 1
+#include <immintrin.h>
+#elif !defined(COMP_GEOM_2D_NO_SIMD) && defined(__aarch64__)
+#define COMP_GEOM_2D_NEON 1
+#include <arm_neon.h>
+#endif
+
+// MappedFile and the file-backed streaming functions use POSIX mmap. Define
+// COMP_GEOM_2D_NO_MMAP to leave them out.
+#if !defined(COMP_GEOM_2D_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#define COMP_GEOM_2D_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Define COMP_GEOM_2D_STATS to collect per-call counters and phase timings
+// (see CallStats). Without it the hooks below expand to nothing.
+#ifdef COMP_GEOM_2D_STATS
+#include <chrono>
+#define COMP_GEOM_2D_COUNT(field, n) (comp_geom_2D::callStats().field += (n))
+#define COMP_GEOM_2D_SCOPE(name) comp_geom_2D::StatsScope cg2dScope(name)
+#define COMP_GEOM_2D_PHASE(phase) comp_geom_2D::PhaseTimer cg2dPhase(comp_geom_2D::callStats().phase##Seconds)
+#define COMP_GEOM_2D_DEPTH() comp_geom_2D::DepthScope cg2dDepth
+#define COMP_GEOM_2D_TRACK(id, buffer) comp_geom_2D::GrowthTracker cg2dTrack##id(buffer)
+#else
+#define COMP_GEOM_2D_COUNT(field, n) ((void)0)
+#define COMP_GEOM_2D_SCOPE(name) ((void)0)
+#define COMP_GEOM_2D_PHASE(phase) ((void)0)
+#define COMP_GEOM_2D_DEPTH() ((void)0)
+#define COMP_GEOM_2D_TRACK(id, buffer) ((void)0)
+#endif
 
 class comp_geom_2D {
+    // Accumulator for products of two coordinates: double keeps floating-point
+    // loops vectorizable (long double input stays long double), long double
+    // keeps 32-bit integer products exact.
+    template <typename T>
+    using Wide = typename std::conditional<std::is_floating_point<T>::value,
+                                           typename std::conditional<(sizeof(T) > sizeof(double)), T, double>::type,
+                                           long double>::type;
+
+    template <typename T>
+    struct Octagon; // hull prefilter, defined with the private helpers
+
 public:
     static constexpr double EPS = 1e-9; // adjust for required accuracy
 
@@ -31,12 +93,125 @@ public:
         }
     };
 
-    template <typename T>
+    // Predicate policies (orientation and in-circle), picked at compile time as
+    // the first template argument: orientation<ExactKernel>(p, q, r),
+    // convexHull<ExactKernel>(points), isInside<ExactKernel>(polygon, p), ...
+    //
+    // Both evaluate integral coordinates exactly (int64 / __int128 for
+    // orientation, __int128 or expansion arithmetic for in-circle), which for
+    // EPS < 1 is the same answer either way and cannot overflow.
+    //
+    // EpsilonKernel (default): an orientation is degenerate when its
+    // determinant is below EPS in magnitude, evaluated in double for float and
+    // double coordinates. In-circle is exact, see below.
+    struct EpsilonKernel {
+        template <typename T>
+        static int orient(Point<T> p, Point<T> q, Point<T> r) {
+            if constexpr (std::is_integral<T>::value) {
+                return integerOrientation(p, q, r);
+            } else {
+                Wide<T> val = ((Wide<T>)q.y - p.y) * ((Wide<T>)r.x - q.x) - ((Wide<T>)q.x - p.x) * ((Wide<T>)r.y - q.y);
+                if (std::abs(val) < EPS) return 0;
+                return (val > 0) ? 1 : 2;
+            }
+        }
+
+        // No fixed tolerance suits a degree-4 determinant at every scale, so
+        // in-circle takes the exact sign, as in ExactKernel. long double
+        // coordinates, which have no exact path, are degenerate within EPS
+        // relative to the determinant's terms.
+        template <typename T>
+        static int inCircle(Point<T> a, Point<T> b, Point<T> c, Point<T> d) {
+            if constexpr (std::is_integral<T>::value || sizeof(T) <= sizeof(double)) {
+                return exactInCircle(a, b, c, d);
+            } else {
+                T permanent;
+                T det = inCircleDet<T>(a, b, c, d, &permanent);
+                if (std::abs(det) <= EPS * permanent) return 0;
+                return det > 0 ? 1 : -1;
+            }
+        }
+    };
+
+    // ExactKernel: the exact sign of each determinant. float and double
+    // coordinates take a plain double fast path guarded by Shewchuk's error
+    // bound and fall back to exact expansion arithmetic only near degeneracy.
+    // long double coordinates have no exact path and use the long double sign.
+    struct ExactKernel {
+        template <typename T>
+        static int orient(Point<T> p, Point<T> q, Point<T> r) {
+            if constexpr (std::is_integral<T>::value) {
+                return integerOrientation(p, q, r);
+            } else if constexpr (sizeof(T) <= sizeof(double)) {
+                double det = orient2d(p.x, p.y, q.x, q.y, r.x, r.y);
+                return det == 0 ? 0 : (det > 0 ? 2 : 1);
+            } else {
+                T val = (q.y - p.y) * (r.x - q.x) - (q.x - p.x) * (r.y - q.y);
+                return val == 0 ? 0 : (val > 0 ? 1 : 2);
+            }
+        }
+
+        template <typename T>
+        static int inCircle(Point<T> a, Point<T> b, Point<T> c, Point<T> d) {
+            if constexpr (std::is_integral<T>::value || sizeof(T) <= sizeof(double)) {
+                return exactInCircle(a, b, c, d);
+            } else {
+                T det = inCircleDet<T>(a, b, c, d);
+                return det == 0 ? 0 : (det > 0 ? 1 : -1);
+            }
+        }
+    };
+
+    template <typename Kernel = EpsilonKernel, typename T>
     static int orientation(Point<T> p, Point<T> q, Point<T> r) {
-        long double val = (long double)(q.y - p.y) * (r.x - q.x) - (long double)(q.x - p.x) * (r.y - q.y);
+        COMP_GEOM_2D_COUNT(orientations, 1);
+        return Kernel::orient(p, q, r); // 0: Collinear, 1: Clockwise, 2: Counter-clockwise
+    }
+
+    // 1 if d lies inside the circle through a, b, c (given counter-clockwise),
+    // 0 if on it, -1 if outside; the sign flips for clockwise a, b, c. Same
+    // kernel policy as orientation(): integral coordinates are exact either way.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static int inCircle(Point<T> a, Point<T> b, Point<T> c, Point<T> d) {
+        COMP_GEOM_2D_COUNT(inCircles, 1);
+        return Kernel::inCircle(a, b, c, d);
+    }
+
+    enum class SimdLevel { Scalar, NEON, AVX2, AVX512 };
+
+    // Instruction set picked at runtime for the batch kernels.
+    static SimdLevel simdLevel() {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
 
-        if (std::abs(val) < EPS) return 0;  // Collinear
-        return (val > 0) ? 1 : 2; // 1: Clockwise, 2: Counter-clockwise
+    // Classifies every r[i] against the directed edge p -> q, writing the same
+    // 0 / 1 / 2 codes as orientation() with the default kernel. Point<double>
+    // input runs on AVX-512, AVX2 or NEON when available, using the same double
+    // arithmetic as EpsilonKernel. Other types use a scalar loop.
+    template <typename T>
+    static void orientationBatch(Point<T> p, Point<T> q, const Point<T>* r, size_t n, int8_t* out) {
+        COMP_GEOM_2D_COUNT(orientations, n);
+        if constexpr (std::is_same<T, double>::value) {
+            switch (simdLevel()) {
+#if defined(COMP_GEOM_2D_X86_SIMD)
+            case SimdLevel::AVX512: orientationBatchAvx512(p, q, r, n, out); return;
+            case SimdLevel::AVX2: orientationBatchAvx2(p, q, r, n, out); return;
+#elif defined(COMP_GEOM_2D_NEON)
+            case SimdLevel::NEON: orientationBatchNeon(p, q, r, n, out); return;
+#endif
+            default: orientationBatchScalar(p, q, r, n, 0, out); return;
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = (int8_t)orientation(p, q, r[i]);
+        }
+    }
+
+    template <typename T>
+    static void orientationBatch(Point<T> p, Point<T> q, const std::vector<Point<T>>& r, std::vector<int8_t>& out) {
+        out.resize(r.size());
+        orientationBatch(p, q, r.data(), r.size(), out.data());
     }
 
     template <typename T>
@@ -44,12 +219,12 @@ public:
         return (q.x <= std::max(p.x, r.x) && q.x >= std::min(p.x, r.x) && q.y <= std::max(p.y, r.y) && q.y >= std::min(p.y, r.y));
     }
 
-    template <typename T>
+    template <typename Kernel = EpsilonKernel, typename T>
     static bool doIntersect(Point<T> p1, Point<T> q1, Point<T> p2, Point<T> q2) {
-        int o1 = orientation(p1, q1, p2);
-        int o2 = orientation(p1, q1, q2);
-        int o3 = orientation(p2, q2, p1);
-        int o4 = orientation(p2, q2, q1);
+        int o1 = orientation<Kernel>(p1, q1, p2);
+        int o2 = orientation<Kernel>(p1, q1, q2);
+        int o3 = orientation<Kernel>(p2, q2, p1);
+        int o4 = orientation<Kernel>(p2, q2, q1);
 
         if (o1 != 0 && o2 != 0 && o3 != 0 && o4 != 0 && o1 != o2 && o3 != o4)
             return true;
@@ -62,193 +237,5512 @@ public:
         return false;
     }
 
-    template <typename T>
+    // Inputs at least this large are first passed through the octagon
+    // prefilter (see hullCandidates) so only the survivors get sorted.
+    static constexpr size_t PrefilterThreshold = 1 << 10;
+
+    // Reports how much of the input the prefilter discarded.
+    struct HullStats {
+        size_t input = 0;
+        size_t candidates = 0; // points left for the sort and chain
+        size_t culled() const { return input - candidates; }
+    };
+
+    template <typename Kernel = EpsilonKernel, typename T>
     static std::vector<Point<T>> convexHull(std::vector<Point<T>>& points) {
-        int n = points.size();
+        HullStats stats;
+        return convexHull<Kernel>(points, stats);
+    }
+
+    // Reorders points: small inputs end up sorted, large ones have the sorted
+    // hull candidates at the front followed by the culled interior points.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<Point<T>> convexHull(std::vector<Point<T>>& points, HullStats& stats) {
+        COMP_GEOM_2D_SCOPE("convexHull");
+        size_t n = points.size();
+        stats.input = stats.candidates = n;
         if (n <= 2) return points;
 
-        std::sort(points.begin(), points.end());
+        if (n >= PrefilterThreshold) {
+            COMP_GEOM_2D_PHASE(prefilter);
+            stats.candidates = cullInterior<Kernel>(points.data(), n);
+        }
+        COMP_GEOM_2D_COUNT(culledPoints, stats.culled());
+
+        {
+            COMP_GEOM_2D_PHASE(sort);
+            std::vector<Point<T>> buffer;
+            sortPointsBy<false>(points.data(), stats.candidates, buffer);
+        }
+        std::vector<Point<T>> hull;
+        COMP_GEOM_2D_PHASE(chain);
+        monotoneChain<Kernel>(points.data(), stats.candidates, hull);
+        return hull;
+    }
+
+    // Working memory for the non-mutating convexHull / polygonDiameter
+    // overloads. Reuse one across calls and they stop allocating once it has
+    // grown; only prefilter survivors are copied into it, not the whole input.
+    // All buffers come from the given memory resource, e.g. a per-thread
+    // std::pmr::monotonic_buffer_resource; the scratch must be destroyed
+    // before that resource is released.
+    template <typename T>
+    struct HullScratch {
+        std::pmr::vector<Point<T>> candidates;
+        std::pmr::vector<Point<T>> chain;
+        std::pmr::vector<Point<T>> hull;
+        HullStats stats; // filled in by the last call
+
+        explicit HullScratch(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : candidates(mr), chain(mr), hull(mr) {}
+    };
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<Point<T>> convexHull(const std::vector<Point<T>>& points, HullScratch<T>& scratch) {
         std::vector<Point<T>> hull;
+        convexHull<Kernel>(points.data(), points.size(), scratch, std::back_inserter(hull));
+        return hull;
+    }
 
-        for (int i = 0; i < n; ++i) {
-            while (hull.size() >= 2 && 
-                   orientation(hull[hull.size() - 2], hull.back(), points[i]) != 2) {
-                hull.pop_back();
-            }
-            hull.push_back(points[i]);
+    // Same result as convexHull(std::vector&) without touching the input: the
+    // candidates are copied into scratch, sorted there, and the hull vertices
+    // are written to out. Returns the output iterator past the last vertex.
+    template <typename Kernel = EpsilonKernel, typename T, typename OutputIt>
+    static OutputIt convexHull(const Point<T>* points, size_t n, HullScratch<T>& scratch, OutputIt out) {
+        COMP_GEOM_2D_SCOPE("convexHull");
+        scratch.stats.input = scratch.stats.candidates = n;
+        if (n <= 2) return std::copy(points, points + n, out);
+
+        COMP_GEOM_2D_TRACK(Candidates, scratch.candidates);
+        COMP_GEOM_2D_TRACK(Chain, scratch.chain);
+        scratch.candidates.clear();
+        Octagon<T> oct;
+        if (n >= PrefilterThreshold) {
+            COMP_GEOM_2D_PHASE(prefilter);
+            oct = octagon<Kernel>(points, n);
+        }
+        if (oct.n >= 3) {
+            COMP_GEOM_2D_PHASE(prefilter);
+            for (size_t i = 0; i < n; ++i)
+                if (!oct.template strictlyInside<Kernel>(points[i])) scratch.candidates.push_back(points[i]);
+        } else {
+            scratch.candidates.assign(points, points + n);
         }
+        scratch.stats.candidates = scratch.candidates.size();
+        COMP_GEOM_2D_COUNT(culledPoints, scratch.stats.culled());
 
-        int t = hull.size() + 1;
-        for (int i = n - 2; i >= 0; i--) {
-            while (hull.size() >= t && 
-                   orientation(hull[hull.size() - 2], hull.back(), points[i]) != 2) {
-                hull.pop_back();
-            }
-            hull.push_back(points[i]);
+        {
+            COMP_GEOM_2D_PHASE(sort);
+            sortPointsBy<false>(scratch.candidates.data(), scratch.candidates.size(), scratch.chain); // chain doubles as the radix buffer
+        }
+        {
+            COMP_GEOM_2D_PHASE(chain);
+            monotoneChain<Kernel>(scratch.candidates.data(), scratch.candidates.size(), scratch.chain);
         }
+        return std::copy(scratch.chain.begin(), scratch.chain.end(), out);
+    }
 
-        hull.pop_back();
+    // Akl-Toussaint heuristic: the extreme points in the eight directions
+    // (+-x, +-y, +-(x + y), +-(x - y)) span an octagon, and nothing strictly
+    // inside it can be on the hull. Returns the remaining points in input order;
+    // O(n), and typically a tiny fraction of uniformly distributed input.
+    template <typename T>
+    static std::vector<Point<T>> hullCandidates(const std::vector<Point<T>>& points) {
+        std::vector<Point<T>> out;
+        Octagon<T> oct = octagon<EpsilonKernel>(points.data(), points.size());
+        if (oct.n < 3) return points;
+        for (const auto& p : points)
+            if (!oct.template strictlyInside<EpsilonKernel>(p)) out.push_back(p);
+        return out;
+    }
+
+    // Runs task(0) ... task(count - 1), possibly concurrently, and returns once all
+    // of them have finished. Wrap an existing thread pool in one of these to run
+    // the parallel algorithms on it.
+    using Executor = std::function<void(size_t count, const std::function<void(size_t)>& task)>;
+
+    // Executor backed by plain std::threads; 0 means std::thread::hardware_concurrency().
+    static Executor threadExecutor(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        return [threads](size_t count, const std::function<void(size_t)>& task) {
+            size_t workers = std::min<size_t>(threads, count);
+            if (workers <= 1) {
+                for (size_t i = 0; i < count; ++i) task(i);
+                return;
+            }
+            std::atomic<size_t> next(0);
+            auto worker = [&]() {
+                for (size_t i; (i = next.fetch_add(1)) < count;) task(i);
+            };
+            std::vector<std::thread> pool;
+            for (size_t w = 1; w < workers; ++w) pool.emplace_back(worker);
+            worker();
+            for (auto& t : pool) t.join();
+        };
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<Point<T>> convexHullParallel(std::vector<Point<T>>& points, unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        return convexHullParallel<Kernel>(points, threadExecutor(threads), threads);
+    }
+
+    // Splits points into `chunks` contiguous ranges, prefilters and sorts each
+    // range in place and computes its hull on the executor, then runs convexHull
+    // over the union of the partial hulls. Every vertex of the full hull is a
+    // vertex of its chunk's hull, so the result matches convexHull(points)
+    // vertex for vertex. points is reordered within each chunk.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<Point<T>> convexHullParallel(std::vector<Point<T>>& points, const Executor& exec, size_t chunks) {
+        constexpr size_t MinChunk = 1 << 14;
+        size_t n = points.size();
+        chunks = std::min(chunks, n / MinChunk);
+        if (chunks <= 1) return convexHull<Kernel>(points);
+
+        std::vector<std::vector<Point<T>>> partial(chunks);
+        exec(chunks, [&](size_t c) {
+            Point<T>* first = points.data() + n * c / chunks;
+            Point<T>* last = points.data() + n * (c + 1) / chunks;
+            last = first + cullInterior<Kernel>(first, last - first);
+            std::vector<Point<T>> buffer;
+            sortPointsBy<false>(first, last - first, buffer);
+            monotoneChain<Kernel>(first, last - first, partial[c]);
+        });
+
+        std::vector<Point<T>> merged;
+        for (const auto& h : partial) merged.insert(merged.end(), h.begin(), h.end());
+        std::vector<Point<T>> hull = convexHull<Kernel>(merged);
+
+        // All points collinear or coincident: convexHull's output then depends on
+        // multiplicities the partial hulls dropped, so fall back to the full set.
+        if (hull.size() < 3) return convexHull<Kernel>(points);
         return hull;
     }
 
-    template <typename T>
+    // Crossing-number test against a horizontal ray from p towards +x.
+    // Points on the boundary count as inside.
+    template <typename Kernel = EpsilonKernel, typename T>
     static bool isInside(const std::vector<Point<T>>& polygon, Point<T> p) {
-        int n = polygon.size();
+        return isInside<Kernel>(polygon.data(), polygon.size(), p);
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static bool isInside(const Point<T>* polygon, size_t n, Point<T> p) {
         if (n < 3) return false;
 
-        T inf = std::numeric_limits<T>::max();
-        Point<T> extreme = {inf, p.y};
+        bool inside = false;
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            int c = rayCrossing<Kernel>(polygon[j], polygon[i], p);
+            if (c == 2) return true;
+            inside ^= (c == 1);
+        }
+        return inside;
+    }
 
-        int count = 0;
-        int i = 0;
-        do {
-            int next = (i + 1) % n;
-            if (doIntersect(polygon[i], polygon[next], p, extreme)) {
-                if (orientation(polygon[i], p, polygon[next]) == 0)
-                    return onSegment(polygon[i], p, polygon[next]);
-                count++;
+    // Point-in-convex-polygon for a counter-clockwise hull such as convexHull()
+    // returns: binary search for the fan triangle (h0, hk, hk+1) containing the
+    // point's direction from h0, then one edge test. O(log n). Boundary points
+    // count as inside.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static bool isInsideConvex(const std::vector<Point<T>>& hull, Point<T> p) {
+        size_t n = hull.size();
+        if (n < 3) return convexDegenerate<Kernel>(hull, p);
+
+        int o1 = orientation<Kernel>(hull[0], hull[1], p);
+        int o2 = orientation<Kernel>(hull[0], hull[n - 1], p);
+        if (o1 == 1 || o2 == 2) return false;
+        if (o1 == 0) return onSegment(hull[0], p, hull[1]);
+        if (o2 == 0) return onSegment(hull[0], p, hull[n - 1]);
+
+        size_t lo = 1, hi = n - 1; // p is not clockwise of h0->hlo, clockwise of h0->hhi
+        while (hi - lo > 1) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (orientation<Kernel>(hull[0], hull[mid], p) == 1) hi = mid;
+            else lo = mid;
+        }
+        return orientation<Kernel>(hull[lo], hull[lo + 1], p) != 1;
+    }
+
+    // Batched isInsideConvex: queries inside the fan at h0 are sorted by angle
+    // once and swept against the fan edges with a single moving pointer, so the
+    // whole batch costs O(n + m log m) rather than O(m log n) with random access.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void isInsideConvexBatch(const std::vector<Point<T>>& hull, const Point<T>* pts, size_t m, uint8_t* out) {
+        size_t n = hull.size();
+        std::vector<size_t> fan;
+        for (size_t i = 0; i < m; ++i) {
+            Point<T> p = pts[i];
+            out[i] = 0;
+            if (n < 3) {
+                out[i] = convexDegenerate<Kernel>(hull, p);
+                continue;
             }
-            i = next;
-        } while (i != 0);
-        // If count is odd, the point is inside.
-        // If count is even, the point is outside.
-        return count % 2 == 1;
+            int o1 = orientation<Kernel>(hull[0], hull[1], p);
+            int o2 = orientation<Kernel>(hull[0], hull[n - 1], p);
+            if (o1 == 1 || o2 == 2) continue;
+            if (o1 == 0) out[i] = onSegment(hull[0], p, hull[1]);
+            else if (o2 == 0) out[i] = onSegment(hull[0], p, hull[n - 1]);
+            else fan.push_back(i);
+        }
+
+        // Within the fan every direction lies in a half-plane, so "counter-clockwise of" is a strict weak order.
+        std::sort(fan.begin(), fan.end(),
+                  [&](size_t a, size_t b) { return orientation<Kernel>(hull[0], pts[a], pts[b]) == 2; });
+        size_t k = 1;
+        for (size_t i : fan) {
+            while (k + 2 < n && orientation<Kernel>(hull[0], hull[k + 1], pts[i]) != 1) ++k;
+            out[i] = orientation<Kernel>(hull[k], hull[k + 1], pts[i]) != 1;
+        }
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void isInsideConvexBatch(const std::vector<Point<T>>& hull, const std::vector<Point<T>>& pts, std::vector<uint8_t>& out) {
+        out.resize(pts.size());
+        isInsideConvexBatch<Kernel>(hull, pts.data(), pts.size(), out.data());
     }
 
     // Calculates the area of a simple (non-self-intersecting) polygon using the Shoelace Formula.
     template <typename T>
     static long double polygonArea(const std::vector<Point<T>>& polygon) {
-        int n = polygon.size();
+        return polygonArea(polygon.data(), polygon.size());
+    }
+
+    template <typename T>
+    static long double polygonArea(const Point<T>* polygon, size_t n) {
         if (n < 3) return 0.0;
         long double area = 0.0;
 
-        for (int i = 0; i < n; ++i) {
-            area += (long double)(polygon[i].x) * polygon[(i + 1) % n].y;
-            area -= (long double)(polygon[(i + 1) % n].x) * polygon[i].y;
+        for (size_t i = 0; i + 1 < n; ++i) {
+            area += (long double)(polygon[i].x) * polygon[i + 1].y;
+            area -= (long double)(polygon[i + 1].x) * polygon[i].y;
         }
+        area += (long double)(polygon[n - 1].x) * polygon[0].y;
+        area -= (long double)(polygon[0].x) * polygon[n - 1].y;
 
         return std::abs(area) / 2.0;
     }
 
+    // A point tagged with its position in the caller's input.
     template <typename T>
-    static long double closestPair(std::vector<Point<T>>& points) {
-        if (points.size() < 2) return 0.0;
-        
-        std::vector<Point<T>> pointsX = points;
-        std::vector<Point<T>> pointsY = points;
+    struct IndexedPoint {
+        Point<T> p;
+        size_t index;
+    };
 
-        // Sort by x and y
-        std::sort(pointsX.begin(), pointsX.end());
-        std::sort(pointsY.begin(), pointsY.end(), sortByY<T>);
+    template <typename T>
+    struct ClosestPairResult {
+        Point<T> first, second;
+        size_t firstIndex, secondIndex; // positions in the input, points.size() if fewer than 2 points
+        long double distance;
+    };
+
+    // Reusable working memory for findClosestPair. Keep one around in a loop and
+    // repeated calls stop allocating once it has grown to the largest input.
+    // Buffers come from mr, as with HullScratch.
+    template <typename T>
+    struct ClosestPairScratch {
+        std::pmr::vector<IndexedPoint<T>> sorted;
+        std::pmr::vector<IndexedPoint<T>> buffer;
 
-        // Call the recursive utility and return the actual distance
-        return std::sqrt(closestPairUtil(pointsX, pointsY));
+        explicit ClosestPairScratch(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : sorted(mr), buffer(mr) {}
+    };
+
+    template <typename T>
+    static long double closestPair(const std::vector<Point<T>>& points) {
+        return findClosestPair(points).distance;
     }
 
     template <typename T>
-    static long double polygonDiameter(std::vector<Point<T>>& points) {
-        if (points.size() < 2) return 0.0;
+    static long double closestPair(const std::vector<Point<T>>& points, ClosestPairScratch<T>& scratch) {
+        return findClosestPair(points, scratch).distance;
+    }
 
-        std::vector<Point<T>> hull = convexHull(points);
+    template <typename T>
+    static ClosestPairResult<T> findClosestPair(const std::vector<Point<T>>& points) {
+        ClosestPairScratch<T> scratch;
+        return findClosestPair(points, scratch);
+    }
 
-        if (hull.size() == 2)
-            return std::sqrt(distSq(hull[0], hull[1]));
-        if (hull.size() < 2)
-            return 0.0;
+    template <typename T>
+    static ClosestPairResult<T> findClosestPair(const std::vector<Point<T>>& points, ClosestPairScratch<T>& scratch) {
+        return findClosestPair(points.data(), points.size(), scratch);
+    }
 
-        int n = hull.size();
-        long double max_dist_sq = 0.0;
-        int j = 1;
+    // Divide and conquer over index ranges of one x-sorted array. Each level merges
+    // its halves by y in place (as in merge sort), so the only extra memory is the
+    // two scratch arrays of size n and nothing is allocated during the recursion.
+    template <typename T>
+    static ClosestPairResult<T> findClosestPair(const Point<T>* points, size_t n, ClosestPairScratch<T>& scratch) {
+        COMP_GEOM_2D_SCOPE("findClosestPair");
+        ClosestPairResult<T> best{Point<T>(), Point<T>(), n, n, 0.0};
+        if (n < 2) return best;
 
-        for (int i = 0; i < n; ++i) {
-            while (true) {
-                Point<T> p1 = hull[i];
-                Point<T> p2 = hull[(i + 1) % n];
-                Point<T> q1 = hull[j];
-                Point<T> q2 = hull[(j + 1) % n];
+        COMP_GEOM_2D_TRACK(Sorted, scratch.sorted);
+        COMP_GEOM_2D_TRACK(Buffer, scratch.buffer);
+        scratch.sorted.resize(n);
+        scratch.buffer.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            scratch.sorted[i] = {points[i], i};
 
-                Point<T> vec_p = {p2.x - p1.x, p2.y - p1.y};
-                Point<T> vec_q = {q2.x - q1.x, q2.y - q1.y};
+        {
+            COMP_GEOM_2D_PHASE(sort);
+            sortElementsBy<false>(scratch.sorted.data(), n, scratch.buffer.data(),
+                                  [](const IndexedPoint<T>& a) -> const Point<T>& { return a.p; },
+                                  bufferResource(scratch.buffer));
+        }
 
-                long double cross_prod = (long double)vec_p.x * vec_q.y - (long double)vec_p.y * vec_q.x; // Cross Product
+        best.distance = std::numeric_limits<long double>::max();
+        {
+            COMP_GEOM_2D_PHASE(recursion);
+            closestPairUtil(scratch.sorted.data(), scratch.buffer.data(), 0, n, best);
+        }
+        best.distance = std::sqrt(best.distance);
+        return best;
+    }
 
-                if (cross_prod > 0)
-                    j = (j + 1) % n;
-                else
-                    break;
+    template <typename T>
+    static long double closestPairParallel(const std::vector<Point<T>>& points, unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        ClosestPairScratch<T> scratch;
+        return findClosestPairParallel(points.data(), points.size(), scratch, threadExecutor(threads), threads).distance;
+    }
+
+    // Task-parallel findClosestPair: the top levels of the recursion are split
+    // with nth_element instead of a full sort, the `tasks` subranges below them
+    // are sorted and solved on the executor, and the merge steps then run level
+    // by level, each level's merges in parallel. Uses the same two scratch
+    // arrays as the serial version and allocates nothing per task. Returns the
+    // same distance as findClosestPair; below 2^14 points per task it is the
+    // serial algorithm.
+    template <typename T>
+    static ClosestPairResult<T> findClosestPairParallel(const Point<T>* points, size_t n, ClosestPairScratch<T>& scratch,
+                                                        const Executor& exec, size_t tasks) {
+        COMP_GEOM_2D_SCOPE("findClosestPairParallel");
+        constexpr size_t MinTask = 1 << 14;
+        tasks = std::min(tasks, n / MinTask);
+        if (tasks <= 1) return findClosestPair(points, n, scratch);
+
+        struct Node {
+            size_t lo, hi;
+            T midX;
+            ClosestPairResult<T> best;
+        };
+        size_t depth = 0;
+        while (((size_t)1 << depth) < tasks) ++depth;
+
+        scratch.sorted.resize(n);
+        scratch.buffer.resize(n);
+        IndexedPoint<T>* pts = scratch.sorted.data();
+        IndexedPoint<T>* buf = scratch.buffer.data();
+        for (size_t i = 0; i < n; ++i)
+            pts[i] = {points[i], i};
+
+        auto byX = [](const IndexedPoint<T>& a, const IndexedPoint<T>& b) { return a.p < b.p; };
+        std::vector<std::vector<Node>> levels(depth + 1);
+        levels[0].push_back({0, n, T(), {}});
+        for (size_t d = 0; d < depth; ++d) {
+            std::vector<Node>& level = levels[d];
+            exec(level.size(), [&](size_t i) {
+                Node& node = level[i];
+                size_t mid = node.lo + (node.hi - node.lo) / 2;
+                std::nth_element(pts + node.lo, pts + mid, pts + node.hi, byX);
+                node.midX = pts[mid].p.x;
+            });
+            for (const Node& node : level) {
+                size_t mid = node.lo + (node.hi - node.lo) / 2;
+                levels[d + 1].push_back({node.lo, mid, T(), {}});
+                levels[d + 1].push_back({mid, node.hi, T(), {}});
             }
+        }
 
-            max_dist_sq = std::max(max_dist_sq, distSq(hull[i], hull[j]));
-            max_dist_sq = std::max(max_dist_sq, distSq(hull[(i + 1) % n], hull[j]));
+        std::vector<Node>& leaves = levels[depth];
+        exec(leaves.size(), [&](size_t i) {
+            Node& node = leaves[i];
+            sortElementsBy<false>(pts + node.lo, node.hi - node.lo, buf + node.lo,
+                                  [](const IndexedPoint<T>& a) -> const Point<T>& { return a.p; });
+            node.best = {Point<T>(), Point<T>(), n, n, std::numeric_limits<long double>::max()};
+            closestPairUtil(pts, buf, node.lo, node.hi, node.best);
+        });
+        for (size_t d = depth; d-- > 0;) {
+            std::vector<Node>& level = levels[d];
+            exec(level.size(), [&](size_t i) {
+                Node& node = level[i];
+                const Node& left = levels[d + 1][2 * i];
+                const Node& right = levels[d + 1][2 * i + 1];
+                node.best = left.best.distance <= right.best.distance ? left.best : right.best;
+                closestPairMerge(pts, buf, node.lo, left.hi, node.hi, node.midX, node.best);
+            });
         }
 
-        return std::sqrt(max_dist_sq);
+        ClosestPairResult<T> best = levels[0][0].best;
+        best.distance = std::sqrt(best.distance);
+        return best;
     }
 
-private:
+    template <typename T>
+    static long double polygonDiameter(std::vector<Point<T>>& points) {
+        HullStats stats;
+        return polygonDiameter(points, stats);
+    }
 
     template <typename T>
-    static long double distSq(Point<T> p1, Point<T> p2) {
-        return (long double)(p1.x - p2.x) * (p1.x - p2.x) +
-               (long double)(p1.y - p2.y) * (p1.y - p2.y);
+    static long double polygonDiameter(std::vector<Point<T>>& points, HullStats& stats) {
+        COMP_GEOM_2D_SCOPE("polygonDiameter");
+        if (points.size() < 2) return 0.0;
+
+        std::vector<Point<T>> hull = convexHull(points, stats);
+        return hullDiameter(hull);
     }
 
     template <typename T>
-    static bool sortByY(const Point<T>& a, const Point<T>& b) {
-        return a.y < b.y;
+    static long double polygonDiameter(const std::vector<Point<T>>& points, HullScratch<T>& scratch) {
+        return polygonDiameter(points.data(), points.size(), scratch);
     }
 
+    // Leaves the input untouched; the hull is built in scratch.
     template <typename T>
-    static long double stripClosest(std::vector<Point<T>>& strip, long double d) {
-        long double min_d = d;
-        
-        for (size_t i = 0; i < strip.size(); ++i) {
-            for (size_t j = i + 1; j < strip.size() && (strip[j].y - strip[i].y) * (strip[j].y - strip[i].y) < min_d; ++j) {
-                long double new_dist = distSq(strip[i], strip[j]);
-                if (new_dist < min_d)
-                    min_d = new_dist;
-            }
+    static long double polygonDiameter(const Point<T>* points, size_t n, HullScratch<T>& scratch) {
+        COMP_GEOM_2D_SCOPE("polygonDiameter");
+        if (n < 2) return 0.0;
+        scratch.hull.clear();
+        convexHull(points, n, scratch, std::back_inserter(scratch.hull));
+        return hullDiameter(scratch.hull);
+    }
+
+    // ---------------------------------------------------------------------
+    // Point sorting
+    // ---------------------------------------------------------------------
+
+    // Sorts by operator< (x, then y). 4- and 8-byte arithmetic coordinates use
+    // a stable LSD radix sort on order-preserving integer keys, other types
+    // std::sort; convexHull, StreamingHull and findClosestPair sort this way.
+    template <typename T>
+    static void sortPoints(Point<T>* points, size_t n) {
+        std::vector<Point<T>> buffer;
+        sortPointsBy<false>(points, n, buffer);
+    }
+
+    template <typename T>
+    static void sortPoints(std::vector<Point<T>>& points) { sortPoints(points.data(), points.size()); }
+
+    // Sorts by y, then x.
+    template <typename T>
+    static void sortPointsByY(Point<T>* points, size_t n) {
+        std::vector<Point<T>> buffer;
+        sortPointsBy<true>(points, n, buffer);
+    }
+
+    template <typename T>
+    static void sortPointsByY(std::vector<Point<T>>& points) { sortPointsByY(points.data(), points.size()); }
+
+    // Radix passes split over `tasks` contiguous blocks on the executor: each
+    // block counts its digits, the counts are prefix-summed per (digit, block)
+    // and every block scatters its share, which keeps the sort stable. Same
+    // result as the serial sorts; below 2^16 points per task it is the serial
+    // sort.
+    template <typename T>
+    static void sortPointsParallel(std::vector<Point<T>>& points, const Executor& exec, size_t tasks) {
+        sortPointsParallelBy<false>(points, exec, tasks);
+    }
+
+    template <typename T>
+    static void sortPointsParallel(std::vector<Point<T>>& points, unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        sortPointsParallelBy<false>(points, threadExecutor(threads), threads);
+    }
+
+    template <typename T>
+    static void sortPointsByYParallel(std::vector<Point<T>>& points, const Executor& exec, size_t tasks) {
+        sortPointsParallelBy<true>(points, exec, tasks);
+    }
+
+    template <typename T>
+    static void sortPointsByYParallel(std::vector<Point<T>>& points, unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        sortPointsParallelBy<true>(points, threadExecutor(threads), threads);
+    }
+
+    enum class SpaceCurve { Hilbert, Morton };
+
+    // Order along a space-filling curve, a cheap preprocessing step that turns
+    // random access into near-streaming access for the later queries and
+    // scans (KdTree and PolygonJoin batches, containment, closest pair).
+    // The bounding box is mapped onto a 2^16 x 2^16 grid by its longer side,
+    // every point gets the Hilbert or Morton number of its cell, and the keys
+    // are radix sorted, so the cost is O(n). Points sharing a cell keep their
+    // input order. Hilbert keeps neighbours closer; Morton keys are cheaper to
+    // compute.
+    //
+    // order[k] is the index of the k-th point along the curve.
+    template <typename T>
+    static void spatialOrder(const Point<T>* points, size_t n, size_t* order, SpaceCurve curve = SpaceCurve::Hilbert) {
+        std::vector<CurveEntry> entries = curveEntries(points, n, curve, Executor(), 1);
+        for (size_t k = 0; k < n; ++k) order[k] = entries[k].index;
+    }
+
+    template <typename T>
+    static std::vector<size_t> spatialOrder(const std::vector<Point<T>>& points, SpaceCurve curve = SpaceCurve::Hilbert) {
+        std::vector<size_t> order(points.size());
+        spatialOrder(points.data(), points.size(), order.data(), curve);
+        return order;
+    }
+
+    // Reorders the points themselves along the curve.
+    template <typename T>
+    static void spatialSort(Point<T>* points, size_t n, SpaceCurve curve = SpaceCurve::Hilbert) {
+        std::vector<CurveEntry> entries = curveEntries(points, n, curve, Executor(), 1);
+        std::vector<Point<T>> sorted(n);
+        for (size_t k = 0; k < n; ++k) sorted[k] = points[entries[k].index];
+        std::copy(sorted.begin(), sorted.end(), points);
+    }
+
+    template <typename T>
+    static void spatialSort(std::vector<Point<T>>& points, SpaceCurve curve = SpaceCurve::Hilbert) {
+        spatialSort(points.data(), points.size(), curve);
+    }
+
+    // Keys, radix passes and the final gather split over `tasks` blocks on the
+    // executor. Same result as the serial forms; below 2^16 points per task
+    // it is the serial sort.
+    template <typename T>
+    static std::vector<size_t> spatialOrderParallel(const std::vector<Point<T>>& points, SpaceCurve curve,
+                                                    const Executor& exec, size_t tasks) {
+        size_t n = points.size();
+        std::vector<CurveEntry> entries = curveEntries(points.data(), n, curve, exec, tasks);
+        std::vector<size_t> order(n);
+        forBlocks(n, CurveBlock, exec, [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) order[k] = entries[k].index;
+        });
+        return order;
+    }
+
+    template <typename T>
+    static void spatialSortParallel(std::vector<Point<T>>& points, SpaceCurve curve, const Executor& exec, size_t tasks) {
+        size_t n = points.size();
+        std::vector<CurveEntry> entries = curveEntries(points.data(), n, curve, exec, tasks);
+        std::vector<Point<T>> sorted(n);
+        forBlocks(n, CurveBlock, exec, [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) sorted[k] = points[entries[k].index];
+        });
+        points.swap(sorted);
+    }
+
+    template <typename T>
+    static void spatialSortParallel(std::vector<Point<T>>& points, SpaceCurve curve = SpaceCurve::Hilbert,
+                                    unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        spatialSortParallel(points, curve, threadExecutor(threads), threads);
+    }
+
+    // ---------------------------------------------------------------------
+    // Rotating calipers
+    // ---------------------------------------------------------------------
+
+    // Rectangle flush with one hull edge: corners[0] -> corners[1] runs along
+    // that edge, corners are counter-clockwise.
+    template <typename T>
+    struct OrientedRect {
+        Point<Wide<T>> corners[4];
+        Wide<T> width = 0;  // along the edge
+        Wide<T> height = 0; // across it
+        Wide<T> area() const { return width * height; }
+        Wide<T> perimeter() const { return 2 * (width + height); }
+    };
+
+    template <typename T>
+    struct CalipersResult {
+        long double diameter = 0;
+        Wide<T> width = 0; // smallest distance between parallel supporting lines
+        OrientedRect<T> minAreaRect;
+        OrientedRect<T> minPerimeterRect;
+    };
+
+    // Diameter, width and both minimal enclosing rectangles of a
+    // counter-clockwise hull such as convexHull() returns, in one O(h) sweep.
+    // The optimal rectangles always have a side on a hull edge, so each edge
+    // is visited once while three calipers (farthest ahead, across and behind)
+    // only ever move forwards.
+    template <typename T, typename Alloc>
+    static CalipersResult<T> rotatingCalipers(const std::vector<Point<T>, Alloc>& hull) {
+        using W = Wide<T>;
+        CalipersResult<T> res;
+        size_t n = hull.size();
+        if (n < 3) {
+            if (n == 0) return res;
+            Point<T> a = hull[0], b = hull[n - 1];
+            res.diameter = std::sqrt(distSq(a, b));
+            OrientedRect<T> rect;
+            rect.corners[0] = rect.corners[3] = {(W)a.x, (W)a.y};
+            rect.corners[1] = rect.corners[2] = {(W)b.x, (W)b.y};
+            rect.width = (W)res.diameter;
+            res.minAreaRect = res.minPerimeterRect = rect;
+            return res;
+        }
+
+        auto next = [n](size_t i) { return i + 1 == n ? 0 : i + 1; };
+        auto along = [&](size_t i, W ex, W ey) { return ex * ((W)hull[next(i)].x - hull[i].x) + ey * ((W)hull[next(i)].y - hull[i].y); };
+        auto across = [&](size_t i, W ex, W ey) { return ex * ((W)hull[next(i)].y - hull[i].y) - ey * ((W)hull[next(i)].x - hull[i].x); };
+
+        long double maxDistSq = 0;
+        W bestArea = std::numeric_limits<W>::max(), bestPerimeter = std::numeric_limits<W>::max();
+        res.width = std::numeric_limits<W>::max();
+        size_t top = 1, ahead = 1, behind = 0;
+
+        for (size_t i = 0; i < n; ++i) {
+            const Point<T>& p = hull[i];
+            W ex = (W)hull[next(i)].x - p.x, ey = (W)hull[next(i)].y - p.y;
+
+            while (across(top, ex, ey) > 0) top = next(top);
+            while (along(ahead, ex, ey) > 0) ahead = next(ahead);
+            if (i == 0) behind = top;
+            while (along(behind, ex, ey) < 0) behind = next(behind);
+
+            maxDistSq = std::max(maxDistSq, distSq(p, hull[top]));
+            maxDistSq = std::max(maxDistSq, distSq(hull[next(i)], hull[top]));
+
+            W len = std::sqrt(ex * ex + ey * ey);
+            W ux = ex / len, uy = ey / len;
+            W lo = ux * ((W)hull[behind].x - p.x) + uy * ((W)hull[behind].y - p.y);
+            W hi = ux * ((W)hull[ahead].x - p.x) + uy * ((W)hull[ahead].y - p.y);
+            W h = ux * ((W)hull[top].y - p.y) - uy * ((W)hull[top].x - p.x);
+            W w = hi - lo;
+
+            res.width = std::min(res.width, h);
+            bool area = w * h < bestArea, perimeter = w + h < bestPerimeter;
+            if (!area && !perimeter) continue;
+
+            OrientedRect<T> rect;
+            rect.width = w;
+            rect.height = h;
+            rect.corners[0] = {p.x + ux * lo, p.y + uy * lo};
+            rect.corners[1] = {p.x + ux * hi, p.y + uy * hi};
+            rect.corners[2] = {rect.corners[1].x - uy * h, rect.corners[1].y + ux * h};
+            rect.corners[3] = {rect.corners[0].x - uy * h, rect.corners[0].y + ux * h};
+            if (area) { bestArea = w * h; res.minAreaRect = rect; }
+            if (perimeter) { bestPerimeter = w + h; res.minPerimeterRect = rect; }
         }
-        return min_d;
+        res.diameter = std::sqrt(maxDistSq);
+        return res;
     }
 
+    // Builds the hull in scratch (input untouched), then sweeps it.
     template <typename T>
-    static long double closestPairUtil(std::vector<Point<T>>& pointsX, std::vector<Point<T>>& pointsY) {
-        int n = pointsX.size();
-        if (n <= 3) {
-            long double min_d = std::numeric_limits<long double>::max();
-            for (int i = 0; i < n; ++i)
-                for (int j = i + 1; j < n; ++j)
-                    min_d = std::min(min_d, distSq(pointsX[i], pointsX[j]));
-            return min_d;
+    static CalipersResult<T> rotatingCalipers(const Point<T>* points, size_t n, HullScratch<T>& scratch) {
+        scratch.hull.clear();
+        convexHull(points, n, scratch, std::back_inserter(scratch.hull));
+        return rotatingCalipers(scratch.hull);
+    }
+
+    template <typename T>
+    static Wide<T> minimumWidth(const std::vector<Point<T>>& hull) {
+        return rotatingCalipers(hull).width;
+    }
+
+    template <typename T>
+    static OrientedRect<T> minAreaBoundingRect(const std::vector<Point<T>>& hull) {
+        return rotatingCalipers(hull).minAreaRect;
+    }
+
+    template <typename T>
+    static OrientedRect<T> minPerimeterBoundingRect(const std::vector<Point<T>>& hull) {
+        return rotatingCalipers(hull).minPerimeterRect;
+    }
+
+    // Every pair of hull vertices (indices into hull) admitting parallel
+    // supporting lines, each unordered pair once. At most 3h/2 pairs.
+    template <typename T>
+    static std::vector<std::pair<size_t, size_t>> antipodalPairs(const std::vector<Point<T>>& hull) {
+        using W = Wide<T>;
+        std::vector<std::pair<size_t, size_t>> pairs;
+        size_t n = hull.size();
+        if (n < 2) return pairs;
+        if (n == 2) {
+            pairs.push_back({0, 1});
+            return pairs;
         }
 
-        int mid = n / 2;
-        Point<T> midPoint = pointsX[mid];
+        // Vertex i + 1 is antipodal to every vertex from the top of edge i to
+        // the top of edge i + 1, plus the far end of an edge parallel to i + 1.
+        auto next = [n](size_t i) { return i + 1 == n ? 0 : i + 1; };
+        auto across = [&](size_t e, size_t k) {
+            W ex = (W)hull[next(e)].x - hull[e].x, ey = (W)hull[next(e)].y - hull[e].y;
+            return ex * ((W)hull[next(k)].y - hull[k].y) - ey * ((W)hull[next(k)].x - hull[k].x);
+        };
+        auto emit = [&](size_t a, size_t b) {
+            if (a < b) pairs.push_back({a, b});
+        };
 
-        std::vector<Point<T>> yL, yR;
-        for (const auto& p : pointsY) {
-            if (p.x < midPoint.x || (p.x == midPoint.x && p.y < midPoint.y))
-                yL.push_back(p);
-            else
-                yR.push_back(p);
+        size_t top = 1;
+        while (across(0, top) > 0) top = next(top);
+        for (size_t i = 0; i < n; ++i) {
+            size_t v = next(i);
+            emit(v, top);
+            W c;
+            while ((c = across(v, top)) > 0) {
+                top = next(top);
+                emit(v, top);
+            }
+            if (c == 0) emit(v, next(top));
         }
+        return pairs;
+    }
 
-        std::vector<Point<T>> xL(pointsX.begin(), pointsX.begin() + mid);
-        std::vector<Point<T>> xR(pointsX.begin() + mid, pointsX.end());
+    // ---------------------------------------------------------------------
+    // Structure-of-arrays point storage
+    // ---------------------------------------------------------------------
 
-        // Recurse
-        long double dL = closestPairUtil(xL, yL);
-        long double dR = closestPairUtil(xR, yR);
-        long double d = std::min(dL, dR);
+    // Minimal allocator handing out Align-byte aligned blocks so coordinate
+    // arrays start on a cache line / vector register boundary.
+    template <typename T, size_t Align = 64>
+    struct AlignedAllocator {
+        using value_type = T;
+        template <typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+        }
+        void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Align)); }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+    };
+
+    template <typename T>
+    struct BoundingBox {
+        Point<T> min, max;
+    };
+
+    // Non-owning view over columnar coordinates, e.g. buffers produced by an
+    // ingest pipeline. Nothing is copied.
+    template <typename T>
+    struct PointCloudView {
+        const T* xs;
+        const T* ys;
+        size_t n;
+
+        PointCloudView() : xs(nullptr), ys(nullptr), n(0) {}
+        PointCloudView(const T* xs, const T* ys, size_t n) : xs(xs), ys(ys), n(n) {}
+        size_t size() const { return n; }
+        Point<T> operator[](size_t i) const { return Point<T>(xs[i], ys[i]); }
+    };
+
+    // Owning structure-of-arrays container with 64-byte aligned x and y columns.
+    template <typename T>
+    struct PointCloud {
+        std::vector<T, AlignedAllocator<T>> xs, ys;
+
+        PointCloud() {}
+        explicit PointCloud(const std::vector<Point<T>>& points) {
+            reserve(points.size());
+            for (const auto& p : points) push_back(p);
+        }
+        PointCloud(const T* x, const T* y, size_t n) : xs(x, x + n), ys(y, y + n) {}
 
-        // Build the "strip" of points close to the dividing line
-        std::vector<Point<T>> strip;
-        for (const auto& p : pointsY)
-            if (std::abs((long double)p.x - midPoint.x) * std::abs((long double)p.x - midPoint.x) < d)
-                strip.push_back(p);
+        size_t size() const { return xs.size(); }
+        bool empty() const { return xs.empty(); }
+        void reserve(size_t n) { xs.reserve(n); ys.reserve(n); }
+        void clear() { xs.clear(); ys.clear(); }
+        void push_back(Point<T> p) { xs.push_back(p.x); ys.push_back(p.y); }
+        Point<T> operator[](size_t i) const { return Point<T>(xs[i], ys[i]); }
 
-        return std::min(d, stripClosest(strip, d));
+        PointCloudView<T> view() const { return PointCloudView<T>(xs.data(), ys.data(), xs.size()); }
+        std::vector<Point<T>> toPoints() const {
+            std::vector<Point<T>> out(size());
+            for (size_t i = 0; i < size(); ++i) out[i] = (*this)[i];
+            return out;
+        }
+    };
+
+    template <typename T>
+    static BoundingBox<T> boundingBox(const Point<T>* points, size_t n) {
+        if (n == 0) return {Point<T>(), Point<T>()};
+        BoundingBox<T> box{points[0], points[0]};
+        for (size_t i = 1; i < n; ++i) {
+            const Point<T>& p = points[i];
+            box.min.x = std::min(box.min.x, p.x);
+            box.min.y = std::min(box.min.y, p.y);
+            box.max.x = std::max(box.max.x, p.x);
+            box.max.y = std::max(box.max.y, p.y);
+        }
+        return box;
+    }
+
+    template <typename T>
+    static BoundingBox<T> boundingBox(const std::vector<Point<T>>& points) {
+        return boundingBox(points.data(), points.size());
+    }
+
+    // x and y are reduced in separate passes so each loop is a plain min/max
+    // reduction over one contiguous column.
+    template <typename T>
+    static BoundingBox<T> boundingBox(PointCloudView<T> cloud) {
+        size_t n = cloud.size();
+        if (n == 0) return {Point<T>(), Point<T>()};
+        T minX = cloud.xs[0], maxX = cloud.xs[0], minY = cloud.ys[0], maxY = cloud.ys[0];
+        for (size_t i = 1; i < n; ++i) {
+            minX = std::min(minX, cloud.xs[i]);
+            maxX = std::max(maxX, cloud.xs[i]);
+        }
+        for (size_t i = 1; i < n; ++i) {
+            minY = std::min(minY, cloud.ys[i]);
+            maxY = std::max(maxY, cloud.ys[i]);
+        }
+        return {Point<T>(minX, minY), Point<T>(maxX, maxY)};
+    }
+
+    // Shoelace formula without the per-vertex modulo; the wraparound edge is
+    // handled once after the loop and the sum is split over independent lanes.
+    template <typename T>
+    static long double polygonArea(PointCloudView<T> polygon) {
+        size_t n = polygon.size();
+        if (n < 3) return 0.0;
+        const T* x = polygon.xs;
+        const T* y = polygon.ys;
+
+        Wide<T> lane[4] = {0, 0, 0, 0};
+        size_t i = 0;
+        for (; i + 4 < n; i += 4)
+            for (size_t k = 0; k < 4; ++k)
+                lane[k] += (Wide<T>)x[i + k] * y[i + k + 1] - (Wide<T>)x[i + k + 1] * y[i + k];
+        for (; i + 1 < n; ++i)
+            lane[0] += (Wide<T>)x[i] * y[i + 1] - (Wide<T>)x[i + 1] * y[i];
+        lane[0] += (Wide<T>)x[n - 1] * y[0] - (Wide<T>)x[0] * y[n - 1];
+
+        long double area = (long double)lane[0] + lane[1] + lane[2] + lane[3];
+        return std::abs(area) / 2.0;
+    }
+
+    // Crossing-number test over the columnar vertex arrays. Points on the
+    // boundary count as inside, as with isInside on a vector.
+    template <typename T>
+    static bool isInside(PointCloudView<T> polygon, Point<T> p) {
+        size_t n = polygon.size();
+        if (n < 3) return false;
+        const T* x = polygon.xs;
+        const T* y = polygon.ys;
+
+        bool inside = false;
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            int c = rayCrossing(Point<T>(x[j], y[j]), Point<T>(x[i], y[i]), p);
+            if (c == 2) return true;
+            inside ^= (c == 1);
+        }
+        return inside;
+    }
+
+    // Index of the point nearest to q, or cloud.size() if the cloud is empty.
+    template <typename T>
+    static size_t nearestPoint(PointCloudView<T> cloud, Point<T> q) {
+        size_t n = cloud.size();
+        size_t best = n;
+        Wide<T> bestD = std::numeric_limits<Wide<T>>::max();
+        for (size_t i = 0; i < n; ++i) {
+            Wide<T> dx = (Wide<T>)cloud.xs[i] - q.x;
+            Wide<T> dy = (Wide<T>)cloud.ys[i] - q.y;
+            Wide<T> d = dx * dx + dy * dy;
+            if (d < bestD) {
+                bestD = d;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Appends to out the indices of all points with distance to q at most r.
+    template <typename T>
+    static void pointsInRadius(PointCloudView<T> cloud, Point<T> q, long double r, std::vector<size_t>& out) {
+        Wide<T> r2 = (Wide<T>)(r * r);
+        for (size_t i = 0; i < cloud.size(); ++i) {
+            Wide<T> dx = (Wide<T>)cloud.xs[i] - q.x;
+            Wide<T> dy = (Wide<T>)cloud.ys[i] - q.y;
+            if (dx * dx + dy * dy <= r2) out.push_back(i);
+        }
+    }
+
+    template <typename T>
+    static BoundingBox<T> boundingBox(const PointCloud<T>& cloud) { return boundingBox(cloud.view()); }
+
+    template <typename T>
+    static long double polygonArea(const PointCloud<T>& polygon) { return polygonArea(polygon.view()); }
+
+    template <typename T>
+    static bool isInside(const PointCloud<T>& polygon, Point<T> p) { return isInside(polygon.view(), p); }
+
+    template <typename T>
+    static size_t nearestPoint(const PointCloud<T>& cloud, Point<T> q) { return nearestPoint(cloud.view(), q); }
+
+    template <typename T>
+    static void pointsInRadius(const PointCloud<T>& cloud, Point<T> q, long double r, std::vector<size_t>& out) {
+        pointsInRadius(cloud.view(), q, r, out);
+    }
+
+    // Everything a statistics pass wants from a polygon, from one sweep.
+    template <typename T>
+    struct PolygonMetrics {
+        Wide<T> signedArea = 0; // positive for counter-clockwise vertex order
+        Wide<T> area = 0;
+        Wide<T> perimeter = 0;
+        Point<Wide<T>> centroid; // area centroid, or the vertex mean when the area is zero
+        BoundingBox<T> box;
+        int orientation = 0; // as orientation(): 0 degenerate, 1 clockwise, 2 counter-clockwise
+    };
+
+    // Area, signed area, centroid, perimeter, bounding box and winding of a
+    // simple polygon in a single pass. The closing edge is peeled out of the
+    // loop, so there is no modulo. Coordinates are taken relative to the first
+    // vertex, which keeps the shoelace and centroid sums from cancelling on
+    // polygons far from the origin.
+    template <typename T>
+    static PolygonMetrics<T> polygonMetrics(const Point<T>* polygon, size_t n) {
+        PolygonMetrics<T> m;
+        if (n == 0) return m;
+        const Wide<T> x0 = polygon[0].x, y0 = polygon[0].y;
+        T minX = polygon[0].x, maxX = minX, minY = polygon[0].y, maxY = minY;
+        Wide<T> a2 = 0, cx = 0, cy = 0, sx = 0, sy = 0, len = 0;
+
+        auto edge = [&](Point<T> p, Point<T> q) {
+            Wide<T> px = p.x - x0, py = p.y - y0, qx = q.x - x0, qy = q.y - y0;
+            Wide<T> cross = px * qy - qx * py;
+            a2 += cross;
+            cx += (px + qx) * cross;
+            cy += (py + qy) * cross;
+            len += std::sqrt((qx - px) * (qx - px) + (qy - py) * (qy - py));
+        };
+        for (size_t i = 0; i + 1 < n; ++i) {
+            Point<T> p = polygon[i], q = polygon[i + 1];
+            edge(p, q);
+            sx += (Wide<T>)q.x - x0;
+            sy += (Wide<T>)q.y - y0;
+            minX = std::min(minX, q.x);
+            maxX = std::max(maxX, q.x);
+            minY = std::min(minY, q.y);
+            maxY = std::max(maxY, q.y);
+        }
+        edge(polygon[n - 1], polygon[0]);
+
+        m.box = {Point<T>(minX, minY), Point<T>(maxX, maxY)};
+        m.perimeter = n < 2 ? 0 : (n == 2 ? len / 2 : len);
+        if (n < 3 || a2 == 0) {
+            m.centroid = Point<Wide<T>>(x0 + sx / n, y0 + sy / n);
+            return m;
+        }
+        m.signedArea = a2 / 2;
+        m.area = std::abs(m.signedArea);
+        m.centroid = Point<Wide<T>>(x0 + cx / (3 * a2), y0 + cy / (3 * a2));
+        m.orientation = a2 > 0 ? 2 : 1;
+        return m;
+    }
+
+    template <typename T>
+    static PolygonMetrics<T> polygonMetrics(const std::vector<Point<T>>& polygon) {
+        return polygonMetrics(polygon.data(), polygon.size());
+    }
+
+    // Signed shoelace area alone, positive for counter-clockwise order.
+    template <typename T>
+    static Wide<T> polygonSignedArea(const Point<T>* polygon, size_t n) {
+        if (n < 3) return 0;
+        Wide<T> a2 = 0;
+        for (size_t i = 0; i + 1 < n; ++i)
+            a2 += (Wide<T>)polygon[i].x * polygon[i + 1].y - (Wide<T>)polygon[i + 1].x * polygon[i].y;
+        a2 += (Wide<T>)polygon[n - 1].x * polygon[0].y - (Wide<T>)polygon[0].x * polygon[n - 1].y;
+        return a2 / 2;
+    }
+
+    template <typename T>
+    static Wide<T> polygonSignedArea(const std::vector<Point<T>>& polygon) {
+        return polygonSignedArea(polygon.data(), polygon.size());
+    }
+
+    // ---------------------------------------------------------------------
+    // Quantized coordinates
+    // ---------------------------------------------------------------------
+
+    // Fixed-point frame for a bounded world: world = origin + q * scale, with
+    // q stored as Point<Q> (int32_t by default, int16_t for tile-relative
+    // storage). Every algorithm takes Point<Q> directly and runs its integral
+    // path: orientation and in-circle are exact, and coordinates kept within
+    // +-Limit leave one bit of headroom, so each coordinate difference fits in
+    // Q and every product of two differences is exact in long double. Areas
+    // and lengths computed on q convert back with area() and length().
+    template <typename Q = int32_t>
+    struct QuantizedFrame {
+        static_assert(std::is_integral<Q>::value && std::is_signed<Q>::value, "QuantizedFrame needs a signed integer type");
+        static constexpr Q Limit = std::numeric_limits<Q>::max() / 2;
+
+        Point<double> origin;
+        double scale = 1; // world units per integer step
+
+        QuantizedFrame() = default;
+        QuantizedFrame(Point<double> origin, double scale) : origin(origin), scale(scale) {}
+
+        // Frame centred on box with the finest scale that keeps the whole box
+        // within +-Limit.
+        static QuantizedFrame fit(const BoundingBox<double>& box) {
+            Point<double> center((box.min.x + box.max.x) / 2, (box.min.y + box.max.y) / 2);
+            double half = std::max(box.max.x - box.min.x, box.max.y - box.min.y) / 2;
+            return QuantizedFrame(center, half > 0 ? half / Limit : 1.0);
+        }
+
+        static QuantizedFrame fit(const std::vector<Point<double>>& points) { return fit(boundingBox(points)); }
+
+        // True if p quantizes without clamping.
+        bool representable(Point<double> p) const {
+            return std::abs((p.x - origin.x) / scale) <= Limit + 0.5 && std::abs((p.y - origin.y) / scale) <= Limit + 0.5;
+        }
+
+        // Nearest grid point, clamped to +-Limit; finite input only.
+        Point<Q> quantize(Point<double> p) const {
+            return Point<Q>(step((p.x - origin.x) / scale), step((p.y - origin.y) / scale));
+        }
+
+        Point<double> dequantize(Point<Q> q) const { return Point<double>(origin.x + q.x * scale, origin.y + q.y * scale); }
+
+        void quantize(const Point<double>* in, size_t n, Point<Q>* out) const {
+            double inv = 1 / scale;
+            for (size_t i = 0; i < n; ++i)
+                out[i] = Point<Q>(step((in[i].x - origin.x) * inv), step((in[i].y - origin.y) * inv));
+        }
+
+        std::vector<Point<Q>> quantize(const std::vector<Point<double>>& in) const {
+            std::vector<Point<Q>> out(in.size());
+            quantize(in.data(), in.size(), out.data());
+            return out;
+        }
+
+        void dequantize(const Point<Q>* in, size_t n, Point<double>* out) const {
+            for (size_t i = 0; i < n; ++i) out[i] = dequantize(in[i]);
+        }
+
+        std::vector<Point<double>> dequantize(const std::vector<Point<Q>>& in) const {
+            std::vector<Point<double>> out(in.size());
+            dequantize(in.data(), in.size(), out.data());
+            return out;
+        }
+
+        // Quantized distances and areas (polygonArea, closestPair, ...) in world units.
+        double length(long double d) const { return (double)(d * scale); }
+        double area(long double a) const { return (double)(a * scale * scale); }
+
+    private:
+        static Q step(double v) { return (Q)std::min<double>(Limit, std::max<double>(-Limit, std::nearbyint(v))); }
+    };
+
+    // ---------------------------------------------------------------------
+    // Polygon batches
+    // ---------------------------------------------------------------------
+
+    // Many polygons in compressed sparse row form: one flat vertex array, and
+    // polygon i is vertices[offsets[i], offsets[i + 1]). offsets holds
+    // count + 1 entries. Batch functions work in blocks of polygons, run on
+    // exec when one is given (e.g. threadExecutor()) and on the calling thread
+    // otherwise, and allocate nothing per polygon.
+
+    // out[i] = polygonArea of polygon i.
+    template <typename T>
+    static void polygonAreaBatch(const Point<T>* vertices, const size_t* offsets, size_t count, long double* out,
+                                 const Executor& exec = Executor()) {
+        forBlocks(count, PolygonBatchBlock, exec, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i)
+                out[i] = std::abs((long double)polygonSignedArea(vertices + offsets[i], offsets[i + 1] - offsets[i]));
+        });
+    }
+
+    template <typename T>
+    static void polygonAreaBatch(const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets,
+                                 std::vector<long double>& out, const Executor& exec = Executor()) {
+        size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+        out.resize(count);
+        polygonAreaBatch(vertices.data(), offsets.data(), count, out.data(), exec);
+    }
+
+    // out[i] = isInside(polygon polygonIds[i], queries[i]) for m queries, so one
+    // polygon can be tested against any number of points and vice versa.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void isInsideBatch(const Point<T>* vertices, const size_t* offsets, const size_t* polygonIds,
+                              const Point<T>* queries, size_t m, uint8_t* out, const Executor& exec = Executor()) {
+        forBlocks(m, PolygonBatchBlock, exec, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                size_t id = polygonIds[i];
+                out[i] = isInside<Kernel>(vertices + offsets[id], offsets[id + 1] - offsets[id], queries[i]);
+            }
+        });
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void isInsideBatch(const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets,
+                              const std::vector<size_t>& polygonIds, const std::vector<Point<T>>& queries,
+                              std::vector<uint8_t>& out, const Executor& exec = Executor()) {
+        out.resize(queries.size());
+        isInsideBatch<Kernel>(vertices.data(), offsets.data(), polygonIds.data(), queries.data(), queries.size(),
+                              out.data(), exec);
+    }
+
+    // Convex hull of every point set in the batch, returned in the same CSR
+    // form: hull i is hullVertices[hullOffsets[i], hullOffsets[i + 1]), as
+    // convexHull() would return it. Each block reuses one HullScratch and the
+    // per-block outputs are concatenated at the end.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void convexHullBatch(const Point<T>* vertices, const size_t* offsets, size_t count,
+                                std::vector<Point<T>>& hullVertices, std::vector<size_t>& hullOffsets,
+                                const Executor& exec = Executor()) {
+        std::vector<std::vector<Point<T>>> blocks((count + PolygonBatchBlock - 1) / PolygonBatchBlock);
+        hullOffsets.assign(count + 1, 0);
+        forBlocks(count, PolygonBatchBlock, exec, [&](size_t lo, size_t hi) {
+            HullScratch<T> scratch;
+            std::vector<Point<T>>& hulls = blocks[lo / PolygonBatchBlock];
+            for (size_t i = lo; i < hi; ++i) {
+                size_t before = hulls.size();
+                convexHull<Kernel>(vertices + offsets[i], offsets[i + 1] - offsets[i], scratch, std::back_inserter(hulls));
+                hullOffsets[i + 1] = hulls.size() - before;
+            }
+        });
+        for (size_t i = 0; i < count; ++i) hullOffsets[i + 1] += hullOffsets[i];
+        hullVertices.clear();
+        hullVertices.reserve(hullOffsets[count]);
+        for (const auto& b : blocks) hullVertices.insert(hullVertices.end(), b.begin(), b.end());
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void convexHullBatch(const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets,
+                                std::vector<Point<T>>& hullVertices, std::vector<size_t>& hullOffsets,
+                                const Executor& exec = Executor()) {
+        size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+        convexHullBatch<Kernel>(vertices.data(), offsets.data(), count, hullVertices, hullOffsets, exec);
+    }
+
+    // ---------------------------------------------------------------------
+    // Streaming hull
+    // ---------------------------------------------------------------------
+
+#ifdef COMP_GEOM_2D_MMAP
+    // Read-only memory mapping of a whole file, unmapped on destruction.
+    class MappedFile {
+    public:
+        MappedFile() {}
+        explicit MappedFile(const char* path) { open(path); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& o) noexcept : ptr(o.ptr), len(o.len), mapped(o.mapped) {
+            o.ptr = nullptr;
+            o.len = 0;
+            o.mapped = false;
+        }
+        MappedFile& operator=(MappedFile&& o) noexcept {
+            if (this != &o) {
+                close();
+                std::swap(ptr, o.ptr);
+                std::swap(len, o.len);
+                std::swap(mapped, o.mapped);
+            }
+            return *this;
+        }
+        ~MappedFile() { close(); }
+
+        // False if the file cannot be opened or mapped. An empty file maps to
+        // a valid, zero-length view.
+        bool open(const char* path) {
+            close();
+            int fd = ::open(path, O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            bool ok = ::fstat(fd, &st) == 0;
+            if (ok && st.st_size > 0) {
+                void* p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ok = p != MAP_FAILED;
+                if (ok) {
+                    ptr = p;
+                    len = (size_t)st.st_size;
+                    ::madvise(ptr, len, MADV_SEQUENTIAL);
+                }
+            }
+            ::close(fd);
+            mapped = ok;
+            return ok;
+        }
+
+        void close() {
+            if (ptr) ::munmap(ptr, len);
+            ptr = nullptr;
+            len = 0;
+            mapped = false;
+        }
+
+        bool valid() const { return mapped; }
+        const unsigned char* data() const { return static_cast<const unsigned char*>(ptr); }
+        size_t size() const { return len; }
+
+    private:
+        void* ptr = nullptr;
+        size_t len = 0;
+        bool mapped = false;
+    };
+#endif
+
+    // Convex hull of a point stream too large to hold in memory. Points are
+    // buffered and merged into the running hull whenever the buffer fills, so
+    // memory stays at O(bufferSize + h). Arriving points strictly inside the
+    // octagon of the current hull's extreme points are dropped straight away,
+    // and on most data that is nearly all of them. With exact predicates
+    // (ExactKernel, or integral coordinates) hull() matches convexHull() over
+    // the concatenated input. Under EpsilonKernel, which of a run of vertices
+    // within EPS of collinear survive can differ. diameter() and boundingBox()
+    // are read off the final hull, with no second pass over the data.
+    template <typename T, typename Kernel = EpsilonKernel>
+    class StreamingHull {
+    public:
+        explicit StreamingHull(size_t bufferSize = 1 << 16) : capacity(std::max<size_t>(bufferSize, 16)) {
+            pending.reserve(capacity);
+        }
+
+        void add(Point<T> p) {
+            ++seen;
+            if (oct.n >= 3 && oct.template strictlyInside<Kernel>(p)) return;
+            pending.push_back(p);
+            if (pending.size() >= capacity) flush();
+        }
+
+        void add(const Point<T>* points, size_t n) {
+            for (size_t i = 0; i < n; ++i) add(points[i]);
+        }
+
+        template <typename InputIt>
+        void add(InputIt first, InputIt last) {
+            for (; first != last; ++first) add(*first);
+        }
+
+        // Pulls chunks from read(buffer, capacity), which fills buffer with up
+        // to capacity points and returns how many, 0 at the end of the stream.
+        void add(const std::function<size_t(Point<T>* buffer, size_t capacity)>& read) {
+            std::vector<Point<T>> chunk(capacity);
+            for (size_t got; (got = read(chunk.data(), chunk.size())) > 0;) add(chunk.data(), got);
+        }
+
+#ifdef COMP_GEOM_2D_MMAP
+        // Adds a flat binary file of Point<T> records in native layout through
+        // a read-only mapping. False if it cannot be mapped or its size is not
+        // a whole number of records.
+        bool addFile(const char* path) {
+            MappedFile file(path);
+            if (!file.valid() || file.size() % sizeof(Point<T>) != 0) return false;
+            add(reinterpret_cast<const Point<T>*>(file.data()), file.size() / sizeof(Point<T>));
+            return true;
+        }
+#endif
+
+        // Counter-clockwise hull of everything added so far.
+        const std::vector<Point<T>>& hull() {
+            if (!pending.empty()) flush();
+            return current;
+        }
+
+        long double diameter() { return hullDiameter(hull()); }
+        BoundingBox<T> boundingBox() { return comp_geom_2D::boundingBox(hull()); }
+        size_t count() const { return seen; } // points added, including dropped ones
+
+        void clear() {
+            pending.clear();
+            current.clear();
+            oct = Octagon<T>();
+            seen = 0;
+        }
+
+    private:
+        size_t capacity;
+        size_t seen = 0;
+        std::vector<Point<T>> pending;
+        std::vector<Point<T>> current;
+        std::vector<Point<T>> next;
+        Octagon<T> oct;
+
+        // Merging is exact: every vertex of the hull of the union is a vertex
+        // of the old hull or one of the pending points.
+        void flush() {
+            if (seen <= 2) {
+                current.insert(current.end(), pending.begin(), pending.end());
+                pending.clear();
+                return;
+            }
+            pending.insert(pending.end(), current.begin(), current.end());
+            sortPointsBy<false>(pending.data(), pending.size(), next);
+            monotoneChain<Kernel>(pending.data(), pending.size(), next);
+            std::swap(current, next);
+            pending.clear();
+            oct = octagon<Kernel>(current.data(), current.size());
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // Binary and text I/O
+    // ---------------------------------------------------------------------
+
+    // Binary point file layout, native byte order (a file from the other
+    // endianness fails the type check):
+    //
+    //   [0, 64)      PointFileHeader
+    //   [64, ...)    count Point<T> records
+    //   then, padded to 8 bytes, polygons + 1 uint64 CSR offsets if polygons > 0
+    //
+    // The point array starts 64-byte aligned in a mapping, so PointFile hands
+    // out pointers into the file that go straight to convexHull, isInside,
+    // polygonArea and the batch functions.
+    struct PointFileHeader {
+        char magic[8];         // "CG2DPTS" and a NUL
+        uint32_t version;      // 1
+        uint32_t type;         // coordTag<T>()
+        uint64_t count;        // points
+        uint64_t polygons;     // 0 for a plain point set
+        unsigned char box[32]; // BoundingBox<T>, zero-padded
+    };
+
+    // 1 int32, 2 int64, 3 float, 4 double; 0 for anything else.
+    template <typename T>
+    static constexpr uint32_t coordTag() {
+        if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 4) return 1;
+        else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == 8) return 2;
+        else if constexpr (std::is_same<T, float>::value) return 3;
+        else if constexpr (std::is_same<T, double>::value) return 4;
+        else return 0;
+    }
+
+    template <typename T>
+    static bool writePoints(const char* path, const Point<T>* points, size_t n) {
+        return writePointFile(path, points, n, nullptr, 0);
+    }
+
+    template <typename T>
+    static bool writePoints(const char* path, const std::vector<Point<T>>& points) {
+        return writePointFile(path, points.data(), points.size(), nullptr, 0);
+    }
+
+    // Polygons in the CSR layout of the batch functions: offsets holds
+    // count + 1 entries into vertices.
+    template <typename T>
+    static bool writePolygons(const char* path, const Point<T>* vertices, const size_t* offsets, size_t count) {
+        return writePointFile(path, vertices, count ? offsets[count] : 0, offsets, count);
+    }
+
+    template <typename T>
+    static bool writePolygons(const char* path, const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets) {
+        size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+        return writePointFile(path, vertices.data(), count ? offsets[count] : 0, offsets.data(), count);
+    }
+
+#ifdef COMP_GEOM_2D_MMAP
+    // Zero-copy reader for the binary format. open() maps the file and checks
+    // the header, the coordinate type against T, and the size, and fails
+    // rather than exposing a truncated file.
+    template <typename T>
+    class PointFile {
+    public:
+        PointFile() {}
+        explicit PointFile(const char* path) { open(path); }
+
+        bool open(const char* path) {
+            header = PointFileHeader();
+            ok = file.open(path) && check();
+            if (!ok) file.close();
+            return ok;
+        }
+
+        bool valid() const { return ok; }
+        size_t size() const { return ok ? header.count : 0; }
+        const Point<T>* points() const { return ok ? reinterpret_cast<const Point<T>*>(file.data() + sizeof(PointFileHeader)) : nullptr; }
+        BoundingBox<T> boundingBox() const {
+            BoundingBox<T> box{Point<T>(), Point<T>()};
+            if (ok) std::memcpy(&box, header.box, sizeof(box));
+            return box;
+        }
+
+        // CSR view of the polygons, or nullptr for a plain point set.
+        size_t polygonCount() const { return ok ? header.polygons : 0; }
+        const size_t* offsets() const {
+            static_assert(sizeof(size_t) == sizeof(uint64_t), "CSR offsets are stored as uint64");
+            return ok && header.polygons ? rawOffsets() : nullptr;
+        }
+        const Point<T>* polygon(size_t i) const { return points() + offsets()[i]; }
+        size_t polygonSize(size_t i) const { return offsets()[i + 1] - offsets()[i]; }
+
+    private:
+        MappedFile file;
+        PointFileHeader header;
+        bool ok = false;
+
+        bool check() {
+            if (file.size() < sizeof(PointFileHeader)) return false;
+            std::memcpy(&header, file.data(), sizeof(header));
+            if (std::memcmp(header.magic, PointFileMagic, sizeof(header.magic)) != 0 || header.version != 1) return false;
+            if (coordTag<T>() == 0 || header.type != coordTag<T>()) return false;
+            uint64_t room = file.size() - sizeof(PointFileHeader); // checked field by field, so hostile counts cannot overflow
+            if (header.count > room / sizeof(Point<T>)) return false;
+            if (header.polygons) {
+                uint64_t start = offsetsStart<T>(header.count);
+                if (start > file.size() || header.polygons >= (file.size() - start) / sizeof(uint64_t)) return false;
+                const size_t* off = rawOffsets();
+                if (off[0] != 0 || off[header.polygons] != header.count) return false;
+                for (uint64_t i = 0; i < header.polygons; ++i)
+                    if (off[i] > off[i + 1]) return false;
+            }
+            return true;
+        }
+
+        const size_t* rawOffsets() const { return reinterpret_cast<const size_t*>(file.data() + offsetsStart<T>(header.count)); }
+    };
+#endif
+
+    // Appends "x y\n" per point, using the shortest representation that
+    // reads back to the same value.
+    template <typename T>
+    static void formatPoints(const Point<T>* points, size_t n, std::string& out) {
+        char buf[128]; // 63 characters per coordinate plus the two separators
+        for (size_t i = 0; i < n; ++i) {
+            char* end = std::to_chars(buf, buf + 63, points[i].x).ptr;
+            *end++ = ' ';
+            end = std::to_chars(end, end + 63, points[i].y).ptr;
+            *end++ = '\n';
+            out.append(buf, end);
+        }
+    }
+
+    template <typename T>
+    static void formatPoints(const std::vector<Point<T>>& points, std::string& out) {
+        formatPoints(points.data(), points.size(), out);
+    }
+
+    // Parses pairs of coordinates separated by spaces, tabs, commas or line
+    // breaks, appending them to out. False on a malformed number or an odd
+    // number of values; out then holds the points read up to that point.
+    template <typename T>
+    static bool parsePoints(const char* first, const char* last, std::vector<Point<T>>& out) {
+        auto separator = [](char c) { return c == ' ' || c == '\t' || c == ',' || c == '\n' || c == '\r'; };
+        T xy[2];
+        size_t k = 0;
+        while (true) {
+            while (first != last && separator(*first)) ++first;
+            if (first == last) return k == 0;
+            // from_chars takes no leading '+'; skip one only before a digit
+            // or '.', so "+-5" stays malformed.
+            if (*first == '+' && last - first > 1 && ((first[1] >= '0' && first[1] <= '9') || first[1] == '.')) ++first;
+            auto res = std::from_chars(first, last, xy[k]);
+            if (res.ec != std::errc() || (res.ptr != last && !separator(*res.ptr))) return false;
+            first = res.ptr;
+            if (++k == 2) {
+                out.push_back(Point<T>(xy[0], xy[1]));
+                k = 0;
+            }
+        }
+    }
+
+    template <typename T>
+    static bool parsePoints(const std::string& text, std::vector<Point<T>>& out) {
+        return parsePoints(text.data(), text.data() + text.size(), out);
+    }
+
+    template <typename T>
+    static bool writePointsText(const char* path, const std::vector<Point<T>>& points) {
+        std::FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        std::string chunk;
+        bool ok = true;
+        for (size_t i = 0; i < points.size() && ok; i += TextChunk) {
+            chunk.clear();
+            formatPoints(points.data() + i, std::min(TextChunk, points.size() - i), chunk);
+            ok = std::fwrite(chunk.data(), 1, chunk.size(), f) == chunk.size();
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+    template <typename T>
+    static bool readPointsText(const char* path, std::vector<Point<T>>& out) {
+        std::FILE* f = std::fopen(path, "rb");
+        if (!f) return false;
+        std::string text;
+        char buf[1 << 16];
+        for (size_t got; (got = std::fread(buf, 1, sizeof(buf), f)) > 0;) text.append(buf, got);
+        bool ok = !std::ferror(f);
+        std::fclose(f);
+        return ok && parsePoints(text, out);
+    }
+
+    // ---------------------------------------------------------------------
+    // Prepared polygons
+    // ---------------------------------------------------------------------
+
+    // A polygon whose edge table is built once for many containment queries.
+    // Each edge stores its endpoints, direction and bounding box as separate
+    // arrays. The crossing-number step is then one y-range test followed by
+    // branch-free compares, with no index arithmetic. containsBatch walks the
+    // edge table once per block of query points, so large tables stay in cache.
+    template <typename T>
+    class PreparedPolygon {
+    public:
+        PreparedPolygon() : box{Point<T>(), Point<T>()} {}
+        explicit PreparedPolygon(const std::vector<Point<T>>& polygon) : box(boundingBox(polygon)) {
+            size_t n = polygon.size();
+            if (n < 3) return;
+            for (auto* v : {&x0, &y0, &x1, &y1, &ex, &ey, &xlo, &xhi, &ylo, &yhi})
+                v->resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                const Point<T>& a = polygon[i];
+                const Point<T>& b = polygon[i + 1 < n ? i + 1 : 0];
+                x0[i] = a.x; y0[i] = a.y;
+                x1[i] = b.x; y1[i] = b.y;
+                ex[i] = (Wide<T>)b.x - a.x;
+                ey[i] = (Wide<T>)b.y - a.y;
+                xlo[i] = std::min(a.x, b.x); xhi[i] = std::max(a.x, b.x);
+                ylo[i] = std::min(a.y, b.y); yhi[i] = std::max(a.y, b.y);
+            }
+        }
+
+        size_t size() const { return x0.size(); }
+        const BoundingBox<T>& bounds() const { return box; }
+
+        // Same answer as isInside(polygon, p): points on the boundary are inside.
+        bool contains(Point<T> p) const {
+            if (size() == 0 || p.x < box.min.x || p.x > box.max.x || p.y < box.min.y || p.y > box.max.y)
+                return false;
+            Wide<T> px = p.x, py = p.y;
+            bool inside = false, boundary = false;
+            for (size_t i = 0; i < size(); ++i)
+                step(i, px, py, inside, boundary);
+            return inside | boundary;
+        }
+
+        void containsBatch(const Point<T>* pts, size_t n, uint8_t* out) const {
+            constexpr size_t Block = 256;
+            Wide<T> px[Block], py[Block];
+            bool inside[Block], boundary[Block];
+            for (size_t base = 0; base < n; base += Block) {
+                size_t m = std::min(Block, n - base);
+                for (size_t k = 0; k < m; ++k) {
+                    px[k] = pts[base + k].x;
+                    py[k] = pts[base + k].y;
+                    inside[k] = boundary[k] = false;
+                }
+                for (size_t i = 0; i < size(); ++i)
+                    for (size_t k = 0; k < m; ++k)
+                        step(i, px[k], py[k], inside[k], boundary[k]);
+                for (size_t k = 0; k < m; ++k)
+                    out[base + k] = inside[k] | boundary[k];
+            }
+        }
+
+        void containsBatch(const std::vector<Point<T>>& pts, std::vector<uint8_t>& out) const {
+            out.resize(pts.size());
+            containsBatch(pts.data(), pts.size(), out.data());
+        }
+
+    private:
+        std::vector<Wide<T>> x0, y0, x1, y1, ex, ey, xlo, xhi, ylo, yhi;
+        BoundingBox<T> box;
+
+        void step(size_t i, Wide<T> px, Wide<T> py, bool& inside, bool& boundary) const {
+            if (py < ylo[i] || py > yhi[i]) return;
+            Wide<T> cross = ex[i] * (py - y0[i]) - (px - x0[i]) * ey[i];
+            inside ^= ((y1[i] > py) != (y0[i] > py)) & ((cross > 0) == (ey[i] > 0));
+            boundary |= (std::abs(cross) < EPS) & (px >= xlo[i]) & (px <= xhi[i]);
+        }
+    };
+
+    // Acceleration index for repeated containment tests on large polygons.
+    // The y-range is split into uniform bands. Each band keeps a copy of every
+    // edge overlapping it, sorted by decreasing max x, so a query scans only
+    // its band and stops at the first edge entirely left of the point: O(k)
+    // for the k edges of one band instead of O(n). The band count defaults to
+    // about one edge entry per band crossing, which keeps the index near 2n entries.
+    // All queries are const and touch no mutable state, so one index can be
+    // shared read-only across threads. save()/load() use a native-endian
+    // binary layout.
+    template <typename T>
+    class PolygonIndex {
+    public:
+        PolygonIndex() : box{Point<T>(), Point<T>()}, minY(0), scale(0), bandStart(1, 0) {}
+        explicit PolygonIndex(const std::vector<Point<T>>& polygon, size_t bands = 0)
+            : PolygonIndex(polygon.data(), polygon.size(), bands) {}
+
+        PolygonIndex(const Point<T>* polygon, size_t n, size_t bands = 0)
+            : box(boundingBox(polygon, n)), minY(box.min.y), scale(0), bandStart(1, 0) {
+            if (n < 3) return;
+
+            std::vector<Edge> all(n);
+            long double spanSum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const Point<T>& a = polygon[i];
+                const Point<T>& b = polygon[i + 1 < n ? i + 1 : 0];
+                all[i] = {(Wide<T>)a.x, (Wide<T>)a.y, (Wide<T>)b.x - a.x, (Wide<T>)b.y - a.y,
+                          (Wide<T>)std::min(a.x, b.x), (Wide<T>)std::max(a.x, b.x),
+                          (Wide<T>)std::min(a.y, b.y), (Wide<T>)std::max(a.y, b.y)};
+                spanSum += std::abs((long double)all[i].ey);
+            }
+
+            Wide<T> height = (Wide<T>)box.max.y - box.min.y;
+            if (bands == 0)
+                bands = spanSum > 0 ? (size_t)std::min<long double>(n, std::max<long double>(1, n * (long double)height / spanSum)) : 1;
+            scale = bandScale(box, bands);
+
+            bandStart.assign(bands + 1, 0);
+            for (const Edge& e : all)
+                for (size_t b = band(e.ylo); b <= band(e.yhi); ++b)
+                    ++bandStart[b + 1];
+            for (size_t b = 0; b < bands; ++b)
+                bandStart[b + 1] += bandStart[b];
+
+            edges.resize(bandStart[bands]);
+            std::vector<size_t> fill(bandStart.begin(), bandStart.end() - 1);
+            for (const Edge& e : all)
+                for (size_t b = band(e.ylo); b <= band(e.yhi); ++b)
+                    edges[fill[b]++] = e;
+            for (size_t b = 0; b < bands; ++b)
+                std::sort(edges.begin() + bandStart[b], edges.begin() + bandStart[b + 1],
+                          [](const Edge& a, const Edge& c) { return a.xhi > c.xhi; });
+        }
+
+        size_t bandCount() const { return bandStart.size() - 1; }
+        size_t entryCount() const { return edges.size(); }
+        const BoundingBox<T>& bounds() const { return box; }
+
+        // Same answer as isInside(polygon, p): points on the boundary are inside.
+        bool contains(Point<T> p) const {
+            if (edges.empty() || p.x < box.min.x || p.x > box.max.x || p.y < box.min.y || p.y > box.max.y)
+                return false;
+            Wide<T> px = p.x, py = p.y;
+            size_t b = band(py);
+            bool inside = false;
+            for (size_t i = bandStart[b]; i < bandStart[b + 1]; ++i) {
+                const Edge& e = edges[i];
+                if (e.xhi < px) break;
+                if (py < e.ylo || py > e.yhi) continue;
+                Wide<T> cross = e.ex * (py - e.y0) - (px - e.x0) * e.ey;
+                if (std::abs(cross) < EPS && px >= e.xlo) return true;
+                inside ^= (py < e.yhi) & (py >= e.ylo) & ((cross > 0) == (e.ey > 0));
+            }
+            return inside;
+        }
+
+        void containsBatch(const Point<T>* pts, size_t n, uint8_t* out) const {
+            for (size_t i = 0; i < n; ++i)
+                out[i] = contains(pts[i]);
+        }
+
+        void containsBatch(const std::vector<Point<T>>& pts, std::vector<uint8_t>& out) const {
+            out.resize(pts.size());
+            containsBatch(pts.data(), pts.size(), out.data());
+        }
+
+        void save(std::ostream& os) const {
+            Header h = header();
+            uint64_t bands = bandCount(), count = edges.size();
+            os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            os.write(reinterpret_cast<const char*>(&box), sizeof(box));
+            os.write(reinterpret_cast<const char*>(&bands), sizeof(bands));
+            os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            os.write(reinterpret_cast<const char*>(bandStart.data()), bandStart.size() * sizeof(uint64_t));
+            os.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(Edge));
+        }
+
+        // Returns false and leaves the index empty if the stream does not hold
+        // an index saved for the same coordinate type, or if its box or band
+        // table is inconsistent. The band scale is not stored; it is derived
+        // from the box and the band count, as the constructor does.
+        bool load(std::istream& is) {
+            *this = PolygonIndex();
+            Header h, expect = header();
+            uint64_t bands = 0, count = 0;
+            PolygonIndex in;
+            is.read(reinterpret_cast<char*>(&h), sizeof(h));
+            if (!is || std::memcmp(&h, &expect, sizeof(h)) != 0) return false;
+            is.read(reinterpret_cast<char*>(&in.box), sizeof(in.box));
+            is.read(reinterpret_cast<char*>(&bands), sizeof(bands));
+            is.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (!is || bands == 0 || bands == std::numeric_limits<uint64_t>::max()) return false;
+            const BoundingBox<T>& b = in.box;
+            if (!std::isfinite((Wide<T>)b.min.x) || !std::isfinite((Wide<T>)b.min.y) || !std::isfinite((Wide<T>)b.max.x) ||
+                !std::isfinite((Wide<T>)b.max.y) || b.min.x > b.max.x || b.min.y > b.max.y)
+                return false;
+            in.minY = b.min.y;
+            in.scale = bandScale(b, bands);
+            if (!readArray(is, in.bandStart, bands + 1) || !readArray(is, in.edges, count) ||
+                in.bandStart.front() != 0 || in.bandStart.back() != count ||
+                !std::is_sorted(in.bandStart.begin(), in.bandStart.end()))
+                return false;
+            *this = std::move(in);
+            return true;
+        }
+
+    private:
+        struct Edge {
+            Wide<T> x0, y0, ex, ey, xlo, xhi, ylo, yhi;
+        };
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t coordSize, wideSize;
+            uint32_t isFloat;
+        };
+
+        BoundingBox<T> box;
+        Wide<T> minY, scale;
+        std::vector<uint64_t> bandStart;
+        std::vector<Edge> edges;
+
+        // Reads n elements into v, growing it a block at a time so that a
+        // corrupt count runs into the end of the stream instead of allocating
+        // whatever it says.
+        template <typename U>
+        static bool readArray(std::istream& is, std::vector<U>& v, uint64_t n) {
+            constexpr uint64_t Block = (1 << 20) / sizeof(U);
+            v.clear();
+            for (uint64_t done = 0; done < n;) {
+                size_t step = (size_t)std::min(Block, n - done);
+                v.resize(v.size() + step);
+                is.read(reinterpret_cast<char*>(v.data() + done), step * sizeof(U));
+                if (!is) return false;
+                done += step;
+            }
+            return true;
+        }
+
+        static Header header() {
+            return {{'C', 'G', 'P', 'I'}, 2, (uint32_t)sizeof(T), (uint32_t)sizeof(Wide<T>),
+                    (uint32_t)std::is_floating_point<T>::value};
+        }
+
+        static Wide<T> bandScale(const BoundingBox<T>& box, size_t bands) {
+            Wide<T> height = (Wide<T>)box.max.y - box.min.y;
+            return height > 0 ? (Wide<T>)bands / height : 0;
+        }
+
+        // Written so that NaN and values past the last band never reach the
+        // size_t conversion.
+        size_t band(Wide<T> y) const {
+            Wide<T> f = (y - minY) * scale;
+            size_t last = bandCount() - 1;
+            if (!(f > 0)) return 0;
+            return f >= (Wide<T>)last ? last : (size_t)f;
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // Spatial join
+    // ---------------------------------------------------------------------
+
+    // Points x polygons containment join, e.g. assigning points to the zone
+    // containing them. Polygons come in the CSR layout of the batch functions
+    // and each gets a PolygonIndex. A uniform grid over the union of their
+    // bounding boxes lists, per cell, the polygons whose box overlaps it, so a
+    // query only tests the few candidates of its cell. Cells are numbered
+    // along a Hilbert curve: join() sorts each block of queries by cell
+    // number, which keeps consecutive tests on the same and neighbouring
+    // polygons. Polygons may overlap; a point reports the lowest id that
+    // contains it, boundary included as in isInside.
+    template <typename T>
+    class PolygonJoin {
+    public:
+        static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+        static constexpr size_t JoinBlock = 1 << 18;
+
+        PolygonJoin() : box{Point<T>(), Point<T>()} {}
+
+        // cellsPerPolygon sets the grid size relative to the polygon count.
+        PolygonJoin(const Point<T>* vertices, const size_t* offsets, size_t count, const Executor& exec = Executor(),
+                    double cellsPerPolygon = 2)
+            : box{Point<T>(), Point<T>()}, polygons(count) {
+            forBlocks(count, PolygonBatchBlock, exec, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i)
+                    polygons[i] = PolygonIndex<T>(vertices + offsets[i], offsets[i + 1] - offsets[i]);
+            });
+            buildGrid(cellsPerPolygon);
+        }
+
+        PolygonJoin(const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets,
+                    const Executor& exec = Executor(), double cellsPerPolygon = 2)
+            : PolygonJoin(vertices.data(), offsets.data(), offsets.empty() ? 0 : offsets.size() - 1, exec,
+                          cellsPerPolygon) {}
+
+        size_t size() const { return polygons.size(); }
+        const BoundingBox<T>& bounds() const { return box; }
+        size_t cellCount() const { return cellStart.size() - 1; }
+
+        // Lowest id of a polygon containing p, None if there is none.
+        uint32_t locate(Point<T> p) const { return locateIn(cellOf(p), p); }
+
+        // out[i] = locate(pts[i]), in blocks run on exec when one is given.
+        // Each block is counting-sorted by cell before it is resolved, unless
+        // it is too small to pay for the histogram.
+        void join(const Point<T>* pts, size_t n, uint32_t* out, const Executor& exec = Executor()) const {
+            forBlocks(n, JoinBlock, exec, [&](size_t lo, size_t hi) {
+                if ((hi - lo) * 4 < cellCount()) {
+                    for (size_t i = lo; i < hi; ++i) out[i] = locate(pts[i]);
+                    return;
+                }
+                std::vector<uint32_t> cell(hi - lo), order(hi - lo);
+                std::vector<size_t> start(cellCount() + 2, 0);
+                for (size_t i = lo; i < hi; ++i) ++start[(cell[i - lo] = (uint32_t)cellOf(pts[i])) + 1];
+                for (size_t c = 0; c + 1 < start.size(); ++c) start[c + 1] += start[c];
+                for (size_t k = 0; k < hi - lo; ++k) order[start[cell[k]]++] = (uint32_t)k;
+                for (uint32_t k : order) out[lo + k] = locateIn(cell[k], pts[lo + k]);
+            });
+        }
+
+        void join(const std::vector<Point<T>>& pts, std::vector<uint32_t>& out, const Executor& exec = Executor()) const {
+            out.resize(pts.size());
+            join(pts.data(), pts.size(), out.data(), exec);
+        }
+
+    private:
+        BoundingBox<T> box;
+        std::vector<PolygonIndex<T>> polygons;
+        size_t cellsX = 0, cellsY = 0;
+        Wide<T> scaleX = 0, scaleY = 0;
+        std::vector<uint32_t> rank;              // row-major cell -> Hilbert number
+        std::vector<size_t> cellStart{0};        // CSR over Hilbert numbers
+        std::vector<uint32_t> cellIds;           // polygon ids, ascending per cell
+
+        void buildGrid(double cellsPerPolygon) {
+            size_t count = polygons.size();
+            bool any = false;
+            for (const auto& poly : polygons) {
+                if (poly.entryCount() == 0) continue;
+                const BoundingBox<T>& b = poly.bounds();
+                if (!any) box = b;
+                box.min.x = std::min(box.min.x, b.min.x); box.min.y = std::min(box.min.y, b.min.y);
+                box.max.x = std::max(box.max.x, b.max.x); box.max.y = std::max(box.max.y, b.max.y);
+                any = true;
+            }
+            if (!any) return;
+
+            // Square-ish cells, about cellsPerPolygon * count of them, at most 2^15 per axis.
+            Wide<T> w = (Wide<T>)box.max.x - box.min.x, h = (Wide<T>)box.max.y - box.min.y;
+            long double cells = std::max<long double>(1, cellsPerPolygon * count);
+            long double aspect = (w > 0 && h > 0) ? (long double)w / h : 1;
+            auto clampAxis = [](long double c) { return (size_t)std::min<long double>(1 << 15, std::max<long double>(1, std::round(c))); };
+            cellsX = w > 0 ? clampAxis(std::sqrt(cells * aspect)) : 1;
+            cellsY = h > 0 ? clampAxis(cells / cellsX) : 1;
+            scaleX = w > 0 ? (Wide<T>)cellsX / w : 0;
+            scaleY = h > 0 ? (Wide<T>)cellsY / h : 0;
+
+            std::vector<std::pair<uint64_t, uint32_t>> curve(cellsX * cellsY);
+            for (size_t cy = 0; cy < cellsY; ++cy)
+                for (size_t cx = 0; cx < cellsX; ++cx)
+                    curve[cy * cellsX + cx] = {hilbertKey((uint32_t)cx, (uint32_t)cy), (uint32_t)(cy * cellsX + cx)};
+            std::sort(curve.begin(), curve.end());
+            rank.resize(curve.size());
+            for (size_t r = 0; r < curve.size(); ++r) rank[curve[r].second] = (uint32_t)r;
+
+            cellStart.assign(curve.size() + 1, 0);
+            auto forCells = [&](const BoundingBox<T>& b, auto&& f) {
+                size_t x0 = axisCell(b.min.x, box.min.x, scaleX, cellsX), x1 = axisCell(b.max.x, box.min.x, scaleX, cellsX);
+                size_t y0 = axisCell(b.min.y, box.min.y, scaleY, cellsY), y1 = axisCell(b.max.y, box.min.y, scaleY, cellsY);
+                for (size_t cy = y0; cy <= y1; ++cy)
+                    for (size_t cx = x0; cx <= x1; ++cx) f(rank[cy * cellsX + cx]);
+            };
+            for (const auto& poly : polygons)
+                if (poly.entryCount() > 0) forCells(poly.bounds(), [&](size_t c) { ++cellStart[c + 1]; });
+            for (size_t c = 0; c + 1 < cellStart.size(); ++c) cellStart[c + 1] += cellStart[c];
+            cellIds.resize(cellStart.back());
+            std::vector<size_t> fill(cellStart.begin(), cellStart.end() - 1);
+            for (size_t i = 0; i < count; ++i)
+                if (polygons[i].entryCount() > 0) forCells(polygons[i].bounds(), [&](size_t c) { cellIds[fill[c]++] = (uint32_t)i; });
+        }
+
+        static size_t axisCell(T v, T lo, Wide<T> scale, size_t cells) {
+            Wide<T> f = ((Wide<T>)v - lo) * scale;
+            return f <= 0 ? 0 : std::min(cells - 1, (size_t)f);
+        }
+
+        // Hilbert number of p's cell, cellCount() if p is outside the bounds.
+        size_t cellOf(Point<T> p) const {
+            if (cellIds.empty() || p.x < box.min.x || p.x > box.max.x || p.y < box.min.y || p.y > box.max.y)
+                return cellCount();
+            return rank[axisCell(p.y, box.min.y, scaleY, cellsY) * cellsX + axisCell(p.x, box.min.x, scaleX, cellsX)];
+        }
+
+        uint32_t locateIn(size_t cell, Point<T> p) const {
+            if (cell >= cellCount()) return None;
+            for (size_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i)
+                if (polygons[cellIds[i]].contains(p)) return cellIds[i];
+            return None;
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // k-d tree
+    // ---------------------------------------------------------------------
+
+    // Static 2D k-d tree in implicit layout: the points are permuted into one
+    // array so that the node of a range [lo, hi) is its middle element, split
+    // on x at even depths and y at odd ones, with both halves stored on either
+    // side of it. Ranges of at most LeafSize points are scanned linearly. No
+    // per-node storage; queries report indices into the original input.
+    template <typename T>
+    class KdTree {
+    public:
+        static constexpr size_t LeafSize = 8;
+
+        KdTree() = default;
+
+        explicit KdTree(const std::vector<Point<T>>& points) { init(points); build(0, nodes.size(), 0); }
+
+        // Builds the top levels on the calling thread, then the `tasks`
+        // subtrees below them on the executor. Same tree as the serial build.
+        KdTree(const std::vector<Point<T>>& points, const Executor& exec, size_t tasks) {
+            init(points);
+            struct Range { size_t lo, hi, axis; };
+            std::vector<Range> ranges{{0, nodes.size(), 0}}, split;
+            while (ranges.size() < tasks) {
+                split.clear();
+                for (const Range& r : ranges) {
+                    if (r.hi - r.lo <= LeafSize) {
+                        split.push_back(r);
+                        continue;
+                    }
+                    size_t mid = partition(r.lo, r.hi, r.axis);
+                    split.push_back({r.lo, mid, r.axis ^ 1});
+                    split.push_back({mid + 1, r.hi, r.axis ^ 1});
+                }
+                if (split.size() == ranges.size()) break;
+                ranges.swap(split);
+            }
+            exec(ranges.size(), [&](size_t i) { build(ranges[i].lo, ranges[i].hi, ranges[i].axis); });
+        }
+
+        size_t size() const { return nodes.size(); }
+        bool empty() const { return nodes.empty(); }
+
+        // Index of the point nearest to q, or size() if the tree is empty.
+        size_t nearest(Point<T> q) const {
+            size_t best = size();
+            Wide<T> bestD = std::numeric_limits<Wide<T>>::max();
+            nearest(0, nodes.size(), 0, q, best, bestD);
+            return best;
+        }
+
+        // The min(k, size()) nearest points, nearest first.
+        void kNearest(Point<T> q, size_t k, std::vector<size_t>& out) const {
+            std::vector<Candidate> heap;
+            heap.reserve(std::min(k, size()));
+            if (k > 0) kNearest(0, nodes.size(), 0, q, k, heap);
+            std::sort_heap(heap.begin(), heap.end());
+            out.resize(heap.size());
+            for (size_t i = 0; i < heap.size(); ++i) out[i] = heap[i].id;
+        }
+
+        // Appends the indices of all points with distance to q at most r.
+        void radius(Point<T> q, long double r, std::vector<size_t>& out) const {
+            radius(0, nodes.size(), 0, q, (Wide<T>)(r * r), out);
+        }
+
+        // Appends the indices of all points inside the closed box.
+        void range(const BoundingBox<T>& box, std::vector<size_t>& out) const {
+            range(0, nodes.size(), 0, box, out);
+        }
+
+        // Batched queries. Queries are split into blocks run on exec when one is
+        // given, on the calling thread otherwise.
+        void nearestBatch(const Point<T>* qs, size_t m, size_t* out, const Executor& exec = Executor()) const {
+            forBlocks(m, exec, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) out[i] = nearest(qs[i]);
+            });
+        }
+
+        void nearestBatch(const std::vector<Point<T>>& qs, std::vector<size_t>& out, const Executor& exec = Executor()) const {
+            out.resize(qs.size());
+            nearestBatch(qs.data(), qs.size(), out.data(), exec);
+        }
+
+        // out holds k entries per query, padded with size() when the tree has
+        // fewer than k points.
+        void kNearestBatch(const Point<T>* qs, size_t m, size_t k, size_t* out, const Executor& exec = Executor()) const {
+            forBlocks(m, exec, [&](size_t lo, size_t hi) {
+                std::vector<size_t> ids;
+                for (size_t i = lo; i < hi; ++i) {
+                    kNearest(qs[i], k, ids);
+                    std::copy(ids.begin(), ids.end(), out + i * k);
+                    std::fill(out + i * k + ids.size(), out + (i + 1) * k, size());
+                }
+            });
+        }
+
+        void kNearestBatch(const std::vector<Point<T>>& qs, size_t k, std::vector<size_t>& out, const Executor& exec = Executor()) const {
+            out.resize(qs.size() * k);
+            kNearestBatch(qs.data(), qs.size(), k, out.data(), exec);
+        }
+
+        // Results in CSR form: the matches of query i are
+        // ids[offsets[i], offsets[i + 1]).
+        void radiusBatch(const std::vector<Point<T>>& qs, long double r, std::vector<size_t>& offsets,
+                         std::vector<size_t>& ids, const Executor& exec = Executor()) const {
+            size_t m = qs.size();
+            std::vector<std::vector<size_t>> blocks((m + BatchBlock - 1) / BatchBlock);
+            offsets.assign(m + 1, 0);
+            forBlocks(m, exec, [&](size_t lo, size_t hi) {
+                std::vector<size_t>& found = blocks[lo / BatchBlock];
+                for (size_t i = lo; i < hi; ++i) {
+                    size_t before = found.size();
+                    radius(qs[i], r, found);
+                    offsets[i + 1] = found.size() - before;
+                }
+            });
+            for (size_t i = 0; i < m; ++i) offsets[i + 1] += offsets[i];
+            ids.clear();
+            ids.reserve(offsets[m]);
+            for (const auto& b : blocks) ids.insert(ids.end(), b.begin(), b.end());
+        }
+
+    private:
+        static constexpr size_t BatchBlock = 1024;
+
+        struct Candidate {
+            Wide<T> d;
+            size_t id;
+            bool operator<(const Candidate& o) const { return d < o.d || (d == o.d && id < o.id); }
+        };
+
+        std::vector<IndexedPoint<T>> nodes;
+
+        void init(const std::vector<Point<T>>& points) {
+            nodes.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) nodes[i] = {points[i], i};
+        }
+
+        static T coord(const Point<T>& p, size_t axis) { return axis ? p.y : p.x; }
+
+        static Wide<T> dist(const Point<T>& a, const Point<T>& b) {
+            Wide<T> dx = (Wide<T>)a.x - b.x, dy = (Wide<T>)a.y - b.y;
+            return dx * dx + dy * dy;
+        }
+
+        // Moves the median of [lo, hi) on axis to the middle slot and returns it.
+        size_t partition(size_t lo, size_t hi, size_t axis) {
+            size_t mid = lo + (hi - lo) / 2;
+            std::nth_element(nodes.begin() + lo, nodes.begin() + mid, nodes.begin() + hi,
+                             [axis](const IndexedPoint<T>& u, const IndexedPoint<T>& v) {
+                                 return coord(u.p, axis) < coord(v.p, axis);
+                             });
+            return mid;
+        }
+
+        void build(size_t lo, size_t hi, size_t axis) {
+            while (hi - lo > LeafSize) {
+                size_t mid = partition(lo, hi, axis);
+                axis ^= 1;
+                build(lo, mid, axis);
+                lo = mid + 1;
+            }
+        }
+
+        void nearest(size_t lo, size_t hi, size_t axis, Point<T> q, size_t& best, Wide<T>& bestD) const {
+            while (hi - lo > LeafSize) {
+                size_t mid = lo + (hi - lo) / 2;
+                Wide<T> d = dist(nodes[mid].p, q);
+                if (d < bestD) {
+                    bestD = d;
+                    best = nodes[mid].index;
+                }
+                Wide<T> diff = (Wide<T>)coord(q, axis) - coord(nodes[mid].p, axis);
+                axis ^= 1;
+                if (diff < 0) {
+                    nearest(lo, mid, axis, q, best, bestD);
+                    if (diff * diff >= bestD) return;
+                    lo = mid + 1;
+                } else {
+                    nearest(mid + 1, hi, axis, q, best, bestD);
+                    if (diff * diff >= bestD) return;
+                    hi = mid;
+                }
+            }
+            for (size_t i = lo; i < hi; ++i) {
+                Wide<T> d = dist(nodes[i].p, q);
+                if (d < bestD) {
+                    bestD = d;
+                    best = nodes[i].index;
+                }
+            }
+        }
+
+        static void offer(std::vector<Candidate>& heap, size_t k, Candidate c) {
+            if (heap.size() < k) {
+                heap.push_back(c);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (c < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = c;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+
+        void kNearest(size_t lo, size_t hi, size_t axis, Point<T> q, size_t k, std::vector<Candidate>& heap) const {
+            while (hi - lo > LeafSize) {
+                size_t mid = lo + (hi - lo) / 2;
+                offer(heap, k, {dist(nodes[mid].p, q), nodes[mid].index});
+                Wide<T> diff = (Wide<T>)coord(q, axis) - coord(nodes[mid].p, axis);
+                axis ^= 1;
+                if (diff < 0) {
+                    kNearest(lo, mid, axis, q, k, heap);
+                    if (heap.size() == k && diff * diff > heap.front().d) return;
+                    lo = mid + 1;
+                } else {
+                    kNearest(mid + 1, hi, axis, q, k, heap);
+                    if (heap.size() == k && diff * diff > heap.front().d) return;
+                    hi = mid;
+                }
+            }
+            for (size_t i = lo; i < hi; ++i) offer(heap, k, {dist(nodes[i].p, q), nodes[i].index});
+        }
+
+        void radius(size_t lo, size_t hi, size_t axis, Point<T> q, Wide<T> r2, std::vector<size_t>& out) const {
+            while (hi - lo > LeafSize) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (dist(nodes[mid].p, q) <= r2) out.push_back(nodes[mid].index);
+                Wide<T> diff = (Wide<T>)coord(q, axis) - coord(nodes[mid].p, axis);
+                axis ^= 1;
+                bool left = diff <= 0 || diff * diff <= r2, right = diff >= 0 || diff * diff <= r2;
+                if (left && right) {
+                    radius(lo, mid, axis, q, r2, out);
+                    lo = mid + 1;
+                } else if (left) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            for (size_t i = lo; i < hi; ++i)
+                if (dist(nodes[i].p, q) <= r2) out.push_back(nodes[i].index);
+        }
+
+        void range(size_t lo, size_t hi, size_t axis, const BoundingBox<T>& box, std::vector<size_t>& out) const {
+            while (hi - lo > LeafSize) {
+                size_t mid = lo + (hi - lo) / 2;
+                const Point<T>& p = nodes[mid].p;
+                if (p.x >= box.min.x && p.x <= box.max.x && p.y >= box.min.y && p.y <= box.max.y) out.push_back(nodes[mid].index);
+                T c = coord(p, axis);
+                bool left = coord(box.min, axis) <= c, right = coord(box.max, axis) >= c;
+                axis ^= 1;
+                if (left && right) {
+                    range(lo, mid, axis, box, out);
+                    lo = mid + 1;
+                } else if (left) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            for (size_t i = lo; i < hi; ++i) {
+                const Point<T>& p = nodes[i].p;
+                if (p.x >= box.min.x && p.x <= box.max.x && p.y >= box.min.y && p.y <= box.max.y) out.push_back(nodes[i].index);
+            }
+        }
+
+        template <typename F>
+        static void forBlocks(size_t m, const Executor& exec, F&& f) {
+            comp_geom_2D::forBlocks(m, BatchBlock, exec, f);
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // Delaunay triangulation
+    // ---------------------------------------------------------------------
+
+    // Delaunay triangulation in half-edge arrays. Triangle t is the vertices
+    // triangles[3t], triangles[3t + 1], triangles[3t + 2] (input indices,
+    // counter-clockwise); half-edge e runs from triangles[e] to
+    // triangles[nextHalfedge(e)] and halfedges[e] is its twin in the adjacent
+    // triangle, or None on the hull. hull lists the hull vertices
+    // counter-clockwise.
+    //
+    // Built by a radial sweep: points are added in order of distance from the
+    // circumcenter of a seed triangle, each is joined to the visible part of
+    // the hull, and edges are flipped until locally Delaunay. A point the sweep
+    // finds inside the hull (possible after rounding in the sort) is located by
+    // a walk and inserted by splitting its triangle instead. Orientation and
+    // in-circle tests go through Kernel.
+    //
+    // Duplicate points are left out of the triangulation; representative(i)
+    // names the kept copy. When all points are collinear there are no
+    // triangles and hull lists the distinct points in order along the line.
+    // Limited to fewer than 2^32 / 6 points.
+    template <typename T, typename Kernel = EpsilonKernel>
+    class Delaunay {
+    public:
+        static constexpr uint32_t None = std::numeric_limits<uint32_t>::max();
+
+        std::vector<uint32_t> triangles;
+        std::vector<uint32_t> halfedges;
+        std::vector<uint32_t> hull;
+
+        Delaunay() = default;
+        explicit Delaunay(const std::vector<Point<T>>& points) : Delaunay(points.data(), points.size()) {}
+        Delaunay(const Point<T>* points, size_t n) : pts(points), count(n) {
+            COMP_GEOM_2D_SCOPE("Delaunay");
+            build();
+        }
+
+        size_t pointCount() const { return count; }
+        size_t triangleCount() const { return triangles.size() / 3; }
+        uint32_t representative(size_t i) const { return rep[i]; }
+
+        static size_t nextHalfedge(size_t e) { return e % 3 == 2 ? e - 2 : e + 1; }
+        static size_t prevHalfedge(size_t e) { return e % 3 == 0 ? e + 2 : e - 1; }
+
+        // Calls f(u, v) once for every edge of the triangulation.
+        template <typename F>
+        void forEachEdge(F&& f) const {
+            if (triangles.empty()) {
+                for (size_t i = 1; i < hull.size(); ++i) f(hull[i - 1], hull[i]);
+                return;
+            }
+            for (size_t e = 0; e < triangles.size(); ++e)
+                if (halfedges[e] == None || halfedges[e] < e) f(triangles[e], triangles[nextHalfedge(e)]);
+        }
+
+    private:
+        const Point<T>* pts = nullptr;
+        size_t count = 0;
+        std::vector<uint32_t> rep;
+        std::vector<uint32_t> hullPrev, hullNext, hullTri, hullHash;
+        std::vector<uint32_t> edgeStack;
+        uint32_t hullStart = 0;
+        Wide<T> cx = 0, cy = 0;
+
+        int orient(uint32_t a, uint32_t b, uint32_t c) const { return orientation<Kernel>(pts[a], pts[b], pts[c]); }
+
+        static Wide<T> dist(const Point<T>& a, const Point<T>& b) {
+            Wide<T> dx = (Wide<T>)a.x - b.x, dy = (Wide<T>)a.y - b.y;
+            return dx * dx + dy * dy;
+        }
+
+        // Offset of the circumcenter of a, b, c from a.
+        static void circumOffset(const Point<T>& a, const Point<T>& b, const Point<T>& c, Wide<T>& x, Wide<T>& y) {
+            Wide<T> dx = (Wide<T>)b.x - a.x, dy = (Wide<T>)b.y - a.y;
+            Wide<T> ex = (Wide<T>)c.x - a.x, ey = (Wide<T>)c.y - a.y;
+            Wide<T> bl = dx * dx + dy * dy, cl = ex * ex + ey * ey;
+            Wide<T> d = 0.5 / (dx * ey - dy * ex);
+            x = (ey * bl - dy * cl) * d;
+            y = (dx * cl - ex * bl) * d;
+        }
+
+        size_t hashKey(const Point<T>& p) const {
+            Wide<T> dx = (Wide<T>)p.x - cx, dy = (Wide<T>)p.y - cy;
+            if (dx == 0 && dy == 0) return 0;
+            Wide<T> q = dx / (std::abs(dx) + std::abs(dy));
+            Wide<T> angle = (dy > 0 ? 3 - q : 1 + q) / 4; // pseudo-angle in [0, 1]
+            size_t key = (size_t)std::floor(angle * (Wide<T>)hullHash.size());
+            return key < hullHash.size() ? key : 0;
+        }
+
+        void link(size_t a, uint32_t b) {
+            halfedges[a] = b;
+            if (b != None) halfedges[b] = (uint32_t)a;
+        }
+
+        uint32_t addTriangle(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c) {
+            uint32_t t = (uint32_t)triangles.size();
+            triangles.insert(triangles.end(), {i0, i1, i2});
+            halfedges.insert(halfedges.end(), {None, None, None});
+            link(t, a);
+            link(t + 1, b);
+            link(t + 2, c);
+            return t;
+        }
+
+        void setTriangle(uint32_t t, uint32_t i0, uint32_t i1, uint32_t i2, uint32_t a, uint32_t b, uint32_t c) {
+            triangles[t] = i0;
+            triangles[t + 1] = i1;
+            triangles[t + 2] = i2;
+            link(t, a);
+            link(t + 1, b);
+            link(t + 2, c);
+        }
+
+        void build() {
+            rep.resize(count);
+            for (size_t i = 0; i < count; ++i) rep[i] = (uint32_t)i;
+            if (count == 0) return;
+
+            Wide<T> minX = pts[0].x, maxX = pts[0].x, minY = pts[0].y, maxY = pts[0].y;
+            for (size_t i = 1; i < count; ++i) {
+                minX = std::min<Wide<T>>(minX, pts[i].x);
+                maxX = std::max<Wide<T>>(maxX, pts[i].x);
+                minY = std::min<Wide<T>>(minY, pts[i].y);
+                maxY = std::max<Wide<T>>(maxY, pts[i].y);
+            }
+            Wide<T> mx = (minX + maxX) / 2, my = (minY + maxY) / 2;
+
+            // Seed: the point nearest the center, its nearest neighbour, and the
+            // third point making the smallest circumcircle with them.
+            uint32_t i0 = 0, i1 = None, i2 = None;
+            Wide<T> best = std::numeric_limits<Wide<T>>::max();
+            for (uint32_t i = 0; i < count; ++i) {
+                Wide<T> dx = pts[i].x - mx, dy = pts[i].y - my;
+                if (dx * dx + dy * dy < best) { best = dx * dx + dy * dy; i0 = i; }
+            }
+            best = std::numeric_limits<Wide<T>>::max();
+            for (uint32_t i = 0; i < count; ++i) {
+                Wide<T> d = dist(pts[i0], pts[i]);
+                if (d > 0 && d < best) { best = d; i1 = i; }
+            }
+            best = std::numeric_limits<Wide<T>>::max();
+            if (i1 != None) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (orient(i0, i1, i) == 0) continue;
+                    Wide<T> x, y;
+                    circumOffset(pts[i0], pts[i1], pts[i], x, y);
+                    Wide<T> r = x * x + y * y;
+                    if (r < best) { best = r; i2 = i; }
+                }
+            }
+            if (i2 == None) return buildCollinear();
+            if (orient(i0, i1, i2) == 1) std::swap(i1, i2);
+
+            Wide<T> ox, oy;
+            circumOffset(pts[i0], pts[i1], pts[i2], ox, oy);
+            cx = pts[i0].x + ox;
+            cy = pts[i0].y + oy;
+            std::vector<Wide<T>> d(count);
+            for (size_t i = 0; i < count; ++i) {
+                Wide<T> dx = (Wide<T>)pts[i].x - cx, dy = (Wide<T>)pts[i].y - cy;
+                d[i] = dx * dx + dy * dy;
+            }
+            std::vector<uint32_t> order(count);
+            for (size_t i = 0; i < count; ++i) order[i] = (uint32_t)i;
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return d[a] < d[b] || (d[a] == d[b] && pts[a] < pts[b]);
+            });
+
+            size_t maxTriangles = 2 * count;
+            triangles.reserve(3 * maxTriangles);
+            halfedges.reserve(3 * maxTriangles);
+            hullPrev.assign(count, None);
+            hullNext.assign(count, None);
+            hullTri.assign(count, None);
+            hullHash.assign((size_t)std::ceil(std::sqrt((double)count)), None);
+
+            hullStart = i0;
+            hullNext[i0] = hullPrev[i2] = i1;
+            hullNext[i1] = hullPrev[i0] = i2;
+            hullNext[i2] = hullPrev[i1] = i0;
+            hullTri[i0] = 0;
+            hullTri[i1] = 1;
+            hullTri[i2] = 2;
+            hullHash[hashKey(pts[i0])] = i0;
+            hullHash[hashKey(pts[i1])] = i1;
+            hullHash[hashKey(pts[i2])] = i2;
+            addTriangle(i0, i1, i2, None, None, None);
+
+            for (size_t k = 0; k < count; ++k) {
+                uint32_t i = order[k];
+                if (k > 0 && pts[i] == pts[order[k - 1]]) {
+                    rep[i] = rep[order[k - 1]];
+                    continue;
+                }
+                if (i == i0 || i == i1 || i == i2) continue;
+
+                // Find a hull edge visible from the point, starting near its angle.
+                uint32_t start = None;
+                size_t key = hashKey(pts[i]);
+                for (size_t j = 0; j < hullHash.size(); ++j) {
+                    start = hullHash[(key + j) % hullHash.size()];
+                    if (start != None && start != hullNext[start]) break;
+                }
+                if (start == None || start == hullNext[start]) start = hullStart;
+                start = hullPrev[start];
+                uint32_t e = start, q;
+                while (orient(e, q = hullNext[e], i) != 1) {
+                    e = q;
+                    if (e == start) {
+                        e = None;
+                        break;
+                    }
+                }
+                if (e == None) {
+                    insertInside(i);
+                    continue;
+                }
+
+                uint32_t t = addTriangle(e, i, hullNext[e], None, None, hullTri[e]);
+                hullTri[i] = legalize(t + 2);
+                hullTri[e] = t;
+
+                uint32_t n = hullNext[e];
+                while (orient(n, q = hullNext[n], i) == 1) {
+                    t = addTriangle(n, i, q, hullTri[i], None, hullTri[n]);
+                    hullTri[i] = legalize(t + 2);
+                    hullNext[n] = n; // removed from the hull
+                    n = q;
+                }
+                if (e == start) {
+                    while (orient(q = hullPrev[e], e, i) == 1) {
+                        t = addTriangle(q, i, e, None, hullTri[e], hullTri[q]);
+                        legalize(t + 2);
+                        hullTri[q] = t;
+                        hullNext[e] = e;
+                        e = q;
+                    }
+                }
+
+                hullStart = hullPrev[i] = e;
+                hullNext[e] = hullPrev[n] = i;
+                hullNext[i] = n;
+                hullHash[hashKey(pts[i])] = i;
+                hullHash[hashKey(pts[e])] = e;
+            }
+
+            uint32_t e = hullStart;
+            do {
+                hull.push_back(e);
+                e = hullNext[e];
+            } while (e != hullStart);
+        }
+
+        void buildCollinear() {
+            std::vector<uint32_t> order(count);
+            for (size_t i = 0; i < count; ++i) order[i] = (uint32_t)i;
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return pts[a] < pts[b]; });
+            for (size_t k = 0; k < count; ++k) {
+                if (k > 0 && pts[order[k]] == pts[order[k - 1]])
+                    rep[order[k]] = rep[order[k - 1]];
+                else
+                    hull.push_back(order[k]);
+            }
+        }
+
+        // Flips edge a and then the edges it exposes until all are locally
+        // Delaunay. Returns the half-edge that ends at a's start vertex in a's
+        // triangle, which the sweep keeps as the new hull edge.
+        uint32_t legalize(uint32_t a) {
+            uint32_t ar = 0;
+            edgeStack.clear();
+            while (true) {
+                uint32_t b = halfedges[a];
+                uint32_t a0 = a - a % 3;
+                ar = a0 + (a + 2) % 3;
+                if (b == None) {
+                    if (edgeStack.empty()) break;
+                    a = edgeStack.back();
+                    edgeStack.pop_back();
+                    continue;
+                }
+                uint32_t b0 = b - b % 3;
+                uint32_t al = a0 + (a + 1) % 3;
+                uint32_t bl = b0 + (b + 2) % 3;
+                uint32_t p0 = triangles[ar], pr = triangles[a], pl = triangles[al], p1 = triangles[bl];
+
+                if (inCircle<Kernel>(pts[p0], pts[pr], pts[pl], pts[p1]) > 0) {
+                    triangles[a] = p1;
+                    triangles[b] = p0;
+                    uint32_t hbl = halfedges[bl];
+                    if (hbl == None) {
+                        // The flipped edge was a hull edge on the far side.
+                        uint32_t e = hullStart;
+                        do {
+                            if (hullTri[e] == bl) {
+                                hullTri[e] = a;
+                                break;
+                            }
+                            e = hullPrev[e];
+                        } while (e != hullStart);
+                    }
+                    link(a, hbl);
+                    link(b, halfedges[ar]);
+                    link(ar, bl);
+                    edgeStack.push_back(b0 + (b + 1) % 3);
+                } else {
+                    if (edgeStack.empty()) break;
+                    a = edgeStack.back();
+                    edgeStack.pop_back();
+                }
+            }
+            return ar;
+        }
+
+        // Points the sweep sees inside the hull: walk to the containing
+        // triangle, then split it (or the edge the point lies on).
+        void insertInside(uint32_t i) {
+            const Point<T>& p = pts[i];
+            size_t tris = triangleCount();
+            uint32_t t = (uint32_t)(tris - 1) * 3;
+            for (size_t steps = 0;; ++steps) {
+                uint32_t next = None;
+                for (uint32_t k = 0; k < 3 && next == None; ++k)
+                    if (orientation<Kernel>(pts[triangles[t + k]], pts[triangles[nextHalfedge(t + k)]], p) == 1) next = t + k;
+                if (next == None) break;
+                if (halfedges[next] == None) return; // outside the hull after all
+                t = halfedges[next] - halfedges[next] % 3;
+                if (steps > tris) { // cycling on near-degenerate input; scan instead
+                    t = None;
+                    for (uint32_t u = 0; u < triangles.size() && t == None; u += 3) {
+                        bool in = true;
+                        for (uint32_t k = 0; k < 3 && in; ++k)
+                            in = orientation<Kernel>(pts[triangles[u + k]], pts[triangles[nextHalfedge(u + k)]], p) != 1;
+                        if (in) t = u;
+                    }
+                    if (t == None) return;
+                    break;
+                }
+            }
+
+            uint32_t onEdge = None, nearest = t;
+            int zeros = 0;
+            for (uint32_t k = 0; k < 3; ++k) {
+                if (orientation<Kernel>(pts[triangles[t + k]], pts[triangles[nextHalfedge(t + k)]], p) == 0) {
+                    onEdge = t + k;
+                    ++zeros;
+                }
+                if (dist(pts[triangles[t + k]], p) < dist(pts[triangles[nearest]], p)) nearest = t + k;
+            }
+            if (zeros > 1 || pts[triangles[nearest]] == p) { // on a vertex (within the kernel's tolerance)
+                rep[i] = rep[triangles[nearest]];
+                return;
+            }
+            if (onEdge == None) splitTriangle(t, i);
+            else splitEdge(onEdge, i);
+        }
+
+        // Records half-edges left on the hull after a split.
+        void fixHull(uint32_t e) {
+            if (halfedges[e] == None) hullTri[triangles[e]] = e;
+        }
+
+        void splitTriangle(uint32_t t, uint32_t p) {
+            uint32_t a = triangles[t], b = triangles[t + 1], c = triangles[t + 2];
+            uint32_t A = halfedges[t], B = halfedges[t + 1], C = halfedges[t + 2];
+            uint32_t t1 = addTriangle(b, c, p, B, None, None);
+            uint32_t t2 = addTriangle(c, a, p, C, None, None);
+            setTriangle(t, a, b, p, A, t1 + 2, t2 + 1);
+            link(t1 + 1, t2 + 2);
+            for (uint32_t e : {t, t1, t2}) fixHull(e);
+            for (uint32_t e : {t, t1, t2}) legalize(e);
+        }
+
+        void splitEdge(uint32_t e, uint32_t p) {
+            uint32_t t = e - e % 3;
+            uint32_t en = (uint32_t)nextHalfedge(e), ep = (uint32_t)prevHalfedge(e);
+            uint32_t a = triangles[e], b = triangles[en], c = triangles[ep];
+            uint32_t An = halfedges[en], Cp = halfedges[ep], u = halfedges[e];
+
+            uint32_t t2 = addTriangle(p, b, c, None, An, None);
+            setTriangle(t, a, p, c, None, t2 + 2, Cp);
+            if (u != None) {
+                uint32_t u0 = u - u % 3;
+                uint32_t un = (uint32_t)nextHalfedge(u), up = (uint32_t)prevHalfedge(u);
+                uint32_t d = triangles[up];
+                uint32_t Du = halfedges[un], Bu = halfedges[up];
+                uint32_t u2 = addTriangle(p, a, d, t, Du, None);
+                setTriangle(u0, b, p, d, t2, u2 + 2, Bu);
+                for (uint32_t x : {t + 2, t2 + 1, u0 + 2, u2 + 1}) fixHull(x);
+                for (uint32_t x : {t + 2, t2 + 1, u0 + 2, u2 + 1}) legalize(x);
+            } else {
+                hullNext[a] = p;
+                hullPrev[p] = a;
+                hullNext[p] = b;
+                hullPrev[b] = p;
+                hullTri[a] = t;
+                hullHash[hashKey(pts[p])] = p;
+                for (uint32_t x : {t + 2, t2 + 1}) fixHull(x);
+                legalize(t + 2);
+                hullTri[p] = legalize(t2 + 1); // p -> b moves if b -> c flips, as in the sweep
+            }
+        }
+    };
+
+    // Euclidean minimum spanning tree as pairs of input indices: Kruskal over
+    // the Delaunay edges, which always contain the EMST. Duplicate points are
+    // attached to their copy by a zero-length edge. O(n log n).
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<std::pair<size_t, size_t>> euclideanMST(const std::vector<Point<T>>& points) {
+        return euclideanMST(points, Delaunay<T, Kernel>(points));
+    }
+
+    template <typename T, typename Kernel>
+    static std::vector<std::pair<size_t, size_t>> euclideanMST(const std::vector<Point<T>>& points, const Delaunay<T, Kernel>& dt) {
+        struct Candidate {
+            Wide<T> d;
+            size_t u, v;
+        };
+        std::vector<Candidate> edges;
+        size_t n = points.size();
+        dt.forEachEdge([&](size_t u, size_t v) {
+            Wide<T> dx = (Wide<T>)points[u].x - points[v].x, dy = (Wide<T>)points[u].y - points[v].y;
+            edges.push_back({dx * dx + dy * dy, u, v});
+        });
+        for (size_t i = 0; i < n; ++i)
+            if (dt.representative(i) != i) edges.push_back({0, dt.representative(i), i});
+        std::sort(edges.begin(), edges.end(), [](const Candidate& a, const Candidate& b) { return a.d < b.d; });
+
+        std::vector<size_t> parent(n);
+        for (size_t i = 0; i < n; ++i) parent[i] = i;
+        auto find = [&](size_t x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+        std::vector<std::pair<size_t, size_t>> tree;
+        tree.reserve(n ? n - 1 : 0);
+        for (const Candidate& e : edges) {
+            size_t ru = find(e.u), rv = find(e.v);
+            if (ru == rv) continue;
+            parent[ru] = rv;
+            tree.push_back({e.u, e.v});
+        }
+        return tree;
+    }
+
+    // Index of the nearest other point for every point (points.size() when
+    // there is none). Each nearest neighbour is a Delaunay neighbour, so this is
+    // one pass over the edges. Duplicates are each other's nearest neighbour.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<size_t> allNearestNeighbors(const std::vector<Point<T>>& points) {
+        return allNearestNeighbors(points, Delaunay<T, Kernel>(points));
+    }
+
+    template <typename T, typename Kernel>
+    static std::vector<size_t> allNearestNeighbors(const std::vector<Point<T>>& points, const Delaunay<T, Kernel>& dt) {
+        size_t n = points.size();
+        std::vector<size_t> nn(n, n);
+        std::vector<Wide<T>> best(n, std::numeric_limits<Wide<T>>::max());
+        auto offer = [&](size_t u, size_t v, Wide<T> d) {
+            if (d < best[u]) {
+                best[u] = d;
+                nn[u] = v;
+            }
+        };
+        dt.forEachEdge([&](size_t u, size_t v) {
+            Wide<T> dx = (Wide<T>)points[u].x - points[v].x, dy = (Wide<T>)points[u].y - points[v].y;
+            Wide<T> d = dx * dx + dy * dy;
+            offer(u, v, d);
+            offer(v, u, d);
+        });
+        for (size_t i = 0; i < n; ++i) {
+            size_t r = dt.representative(i);
+            if (r == i) continue;
+            offer(i, r, 0);
+            offer(r, i, 0);
+        }
+        return nn;
+    }
+
+    // ---------------------------------------------------------------------
+    // Polygon clipping
+    // ---------------------------------------------------------------------
+
+    // Greiner-Hormann vertex: an input vertex or a crossing, linked into its
+    // ring in order and, for crossings, to its twin in the other ring.
+    template <typename T>
+    struct ClipNode {
+        Point<Wide<T>> p;
+        size_t next, prev, twin;
+        bool crossing, entry, visited;
+    };
+
+    template <typename T>
+    struct ClipCrossing {
+        size_t i, j;   // edge i of the subject, edge j of the clip polygon
+        Wide<T> s, t;  // parameters along them
+        Point<Wide<T>> p;
+        size_t subjectNode, clipNode;
+    };
+
+    // Working memory for the clipping functions. Reuse one per thread across
+    // calls and clipping stops allocating once the buffers have grown.
+    template <typename T>
+    struct ClipScratch {
+        std::pmr::vector<Point<Wide<T>>> ping, pong;
+        std::pmr::vector<Point<Wide<T>>> subject, clip;
+        std::pmr::vector<ClipNode<T>> subjectNodes, clipNodes;
+        std::pmr::vector<ClipCrossing<T>> crossings;
+        std::pmr::vector<size_t> order;
+
+        explicit ClipScratch(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : ping(mr), pong(mr), subject(mr), clip(mr), subjectNodes(mr), clipNodes(mr), crossings(mr), order(mr) {}
+    };
+
+    enum class BooleanOp { Intersection, Union, Difference };
+
+    // Sutherland-Hodgman against an axis-aligned box: the fast path for cutting
+    // polygons into tiles. Any simple polygon works as the subject; a concave
+    // one that leaves and re-enters the box comes back as one ring joined
+    // along the box boundary. Intersection points of integral polygons are
+    // rounded to the nearest integer.
+    template <typename T, typename Alloc>
+    static void clipRect(const std::vector<Point<T>>& subject, const BoundingBox<T>& box, std::vector<Point<T>, Alloc>& out,
+                         ClipScratch<T>& scratch) {
+        using W = Wide<T>;
+        auto& in = scratch.ping;
+        auto& next = scratch.pong;
+        in.resize(subject.size());
+        for (size_t i = 0; i < subject.size(); ++i) in[i] = {(W)subject[i].x, (W)subject[i].y};
+
+        // One half-plane at a time: axis 0 clips x, 1 clips y; keep >= bound
+        // when upper is false, <= bound otherwise.
+        auto pass = [&](int axis, bool upper, W bound) {
+            next.clear();
+            size_t n = in.size();
+            for (size_t i = 0; i < n; ++i) {
+                const Point<W>& a = in[i == 0 ? n - 1 : i - 1];
+                const Point<W>& b = in[i];
+                W ca = axis ? a.y : a.x, cb = axis ? b.y : b.x;
+                bool ina = upper ? ca <= bound : ca >= bound;
+                bool inb = upper ? cb <= bound : cb >= bound;
+                if (ina != inb) {
+                    W t = (bound - ca) / (cb - ca);
+                    Point<W> p = axis ? Point<W>(a.x + t * (b.x - a.x), bound) : Point<W>(bound, a.y + t * (b.y - a.y));
+                    next.push_back(p);
+                }
+                if (inb) next.push_back(b);
+            }
+            in.swap(next);
+        };
+        pass(0, false, box.min.x);
+        pass(0, true, box.max.x);
+        pass(1, false, box.min.y);
+        pass(1, true, box.max.y);
+        emitRing(in, out);
+    }
+
+    template <typename T>
+    static std::vector<Point<T>> clipRect(const std::vector<Point<T>>& subject, const BoundingBox<T>& box) {
+        ClipScratch<T> scratch;
+        std::vector<Point<T>> out;
+        clipRect(subject, box, out, scratch);
+        return out;
+    }
+
+    // Sutherland-Hodgman against a convex clipper of either orientation.
+    // Points on a clip edge count as inside. Same caveats as clipRect.
+    template <typename Kernel = EpsilonKernel, typename T, typename Alloc>
+    static void clipConvex(const std::vector<Point<T>>& subject, const std::vector<Point<T>>& clipper,
+                           std::vector<Point<T>, Alloc>& out, ClipScratch<T>& scratch) {
+        using W = Wide<T>;
+        auto& in = scratch.ping;
+        auto& next = scratch.pong;
+        in.resize(subject.size());
+        for (size_t i = 0; i < subject.size(); ++i) in[i] = {(W)subject[i].x, (W)subject[i].y};
+
+        size_t m = clipper.size();
+        bool ccw = signedArea2(clipper) >= 0;
+        for (size_t j = 0; j < m && !in.empty(); ++j) {
+            Point<T> c0 = clipper[j], c1 = clipper[j + 1 < m ? j + 1 : 0];
+            if (!ccw) std::swap(c0, c1);
+            Point<W> a0((W)c0.x, (W)c0.y), a1((W)c1.x, (W)c1.y);
+            next.clear();
+            size_t n = in.size();
+            for (size_t i = 0; i < n; ++i) {
+                const Point<W>& p = in[i == 0 ? n - 1 : i - 1];
+                const Point<W>& q = in[i];
+                bool inp = orientation<Kernel>(a0, a1, p) != 1;
+                bool inq = orientation<Kernel>(a0, a1, q) != 1;
+                if (inp != inq) next.push_back(lineIntersection(p, q, a0, a1));
+                if (inq) next.push_back(q);
+            }
+            in.swap(next);
+        }
+        emitRing(in, out);
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<Point<T>> clipConvex(const std::vector<Point<T>>& subject, const std::vector<Point<T>>& clipper) {
+        ClipScratch<T> scratch;
+        std::vector<Point<T>> out;
+        clipConvex<Kernel>(subject, clipper, out, scratch);
+        return out;
+    }
+
+    // Boolean operation on two simple polygons (any orientation) by
+    // Greiner-Hormann. Writes the result rings to out: outer boundaries
+    // counter-clockwise, holes clockwise. Vertices lying exactly on the other
+    // polygon's edges are degenerate for Greiner-Hormann; the clip polygon is
+    // then nudged by a relative 1e-9 of the common extent and the operation
+    // retried, so output vertices can sit that far from the exact answer and
+    // slivers of that width are dropped. Tests all n * m edge pairs behind a
+    // bounding box reject. Returns false, with out empty, if the contact is
+    // still degenerate after every nudge; an empty result that is the actual
+    // answer returns true.
+    template <typename T>
+    static bool polygonBoolean(const std::vector<Point<T>>& a, const std::vector<Point<T>>& b, BooleanOp op,
+                               std::vector<std::vector<Point<T>>>& out, ClipScratch<T>& scratch) {
+        using W = Wide<T>;
+        out.clear();
+        auto load = [](const std::vector<Point<T>>& poly, std::pmr::vector<Point<W>>& ring) {
+            ring.resize(poly.size());
+            for (size_t i = 0; i < poly.size(); ++i) ring[i] = {(W)poly[i].x, (W)poly[i].y};
+            if (signedArea2(ring) < 0) std::reverse(ring.begin(), ring.end());
+        };
+        load(a, scratch.subject);
+        load(b, scratch.clip);
+        bool emptyA = scratch.subject.size() < 3, emptyB = scratch.clip.size() < 3;
+        if (emptyA || emptyB) {
+            const std::pmr::vector<Point<W>>* keep = nullptr;
+            if (op == BooleanOp::Union) keep = !emptyA ? &scratch.subject : (!emptyB ? &scratch.clip : nullptr);
+            if (op == BooleanOp::Difference && !emptyA) keep = &scratch.subject;
+            if (keep) {
+                out.emplace_back();
+                emitRing(*keep, out.back());
+                if (out.back().empty()) out.pop_back();
+            }
+            return true;
+        }
+
+        W extent = 0;
+        for (const auto* ring : {&scratch.subject, &scratch.clip})
+            for (const auto& p : *ring) extent = std::max({extent, std::abs(p.x), std::abs(p.y)});
+        W scale = extent > 0 ? extent : 1;
+        W nudge = scale * (W)1e-9, moved = 0;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            if (findCrossings(scratch)) {
+                // Slivers along edges the nudge pulled apart are dropped.
+                greinerHormann(op, out, scratch, 16 * moved * scale);
+                return true;
+            }
+            // Degenerate contact: move every clip vertex by a small pseudo-random offset.
+            for (size_t i = 0; i < scratch.clip.size(); ++i) {
+                uint64_t h = (i + 1) * 0x9E3779B97F4A7C15ull + (uint64_t)attempt * 0xBF58476D1CE4E5B9ull;
+                h ^= h >> 31;
+                scratch.clip[i].x += nudge * (W)((int)(h & 0xFFFF) - 0x8000) / 0x8000;
+                scratch.clip[i].y += nudge * (W)((int)((h >> 16) & 0xFFFF) - 0x8000) / 0x8000;
+            }
+            moved += nudge;
+            nudge *= 4;
+        }
+        return false;
+    }
+
+    // Returns no rings on failure as well; use the scratch form to tell the
+    // two apart.
+    template <typename T>
+    static std::vector<std::vector<Point<T>>> polygonBoolean(const std::vector<Point<T>>& a, const std::vector<Point<T>>& b,
+                                                             BooleanOp op) {
+        ClipScratch<T> scratch;
+        std::vector<std::vector<Point<T>>> out;
+        polygonBoolean(a, b, op, out, scratch);
+        return out;
+    }
+
+    // ---------------------------------------------------------------------
+    // Triangulation
+    // ---------------------------------------------------------------------
+
+    // Vertex of the working ring: i is its index in the caller's polygon.
+    // Rings are split by copying nodes, so several nodes can share one i.
+    template <typename T>
+    struct TriangulationNode {
+        Point<T> p;
+        uint32_t i, prev, next;
+        bool removed;
+    };
+
+    // Working memory for the triangulation functions. Reuse one per thread
+    // across calls and triangulating stops allocating once the buffers have
+    // grown.
+    template <typename T>
+    struct TriangulationScratch {
+        std::pmr::vector<TriangulationNode<T>> nodes;
+        std::pmr::vector<uint64_t> reflex; // ear clipping: z-order key << 32 | node
+        std::pmr::vector<Point<T>> points; // monotone: the filtered ring
+        std::pmr::vector<uint32_t> ring, order, helper, diagonals, edgeStart, edges, slot, piece, stack;
+        std::pmr::vector<uint8_t> visited;
+
+        explicit TriangulationScratch(std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+            : nodes(mr), reflex(mr), points(mr), ring(mr), order(mr), helper(mr), diagonals(mr), edgeStart(mr),
+              edges(mr), slot(mr), piece(mr), stack(mr), visited(mr) {}
+    };
+
+    enum class TriangulationMethod { EarClipping, Monotone };
+
+    // Triangulates a simple polygon of either orientation by ear clipping.
+    // Appends the triangles to indices as counter-clockwise triples of vertex
+    // indices, each plus base, and returns how many it appended. Repeated and
+    // collinear vertices are dropped first, so a simple polygon gets n - 2
+    // triangles less one per dropped vertex. Above EarIndexThreshold vertices
+    // the ear test looks up reflex vertices in a z-order index of the ring
+    // instead of walking it, which keeps large polygons near O(n log n) in
+    // practice. Self-intersecting input falls through to earcut's recovery
+    // passes (cure local crossings, then split along a valid diagonal) and
+    // still comes back as triangles, though they need not tile the polygon.
+    template <typename Kernel = EpsilonKernel, typename T, typename Alloc>
+    static size_t triangulate(const Point<T>* polygon, size_t n, std::vector<uint32_t, Alloc>& indices,
+                              TriangulationScratch<T>& scratch, uint32_t base = 0) {
+        size_t before = indices.size();
+        uint32_t start = triangulationRing<Kernel>(polygon, n, scratch);
+        if (start == TriangulationNone) return 0;
+        EarGrid grid;
+        if (n > EarIndexThreshold) {
+            BoundingBox<T> box = boundingBox(polygon, n);
+            double w = (double)box.max.x - (double)box.min.x, h = (double)box.max.y - (double)box.min.y;
+            double cells = (1u << EarGridBits) - 1;
+            if (w > 0 && h > 0) grid = {(double)box.min.x, (double)box.min.y, cells / w, cells / h, true};
+        }
+        earClip<Kernel>(scratch, start, indices, base, grid, 0);
+        return (indices.size() - before) / 3;
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<uint32_t> triangulate(const std::vector<Point<T>>& polygon) {
+        TriangulationScratch<T> scratch;
+        std::vector<uint32_t> indices;
+        triangulate<Kernel>(polygon.data(), polygon.size(), indices, scratch);
+        return indices;
+    }
+
+    // Same contract as triangulate() by the sweep-line alternative: split
+    // the polygon into y-monotone pieces at its split and merge vertices
+    // (de Berg et al., ch. 3), then triangulate each piece with the stack
+    // walk down its two chains. O(n log n) whatever the shape; the sweep
+    // status is a std::pmr::set on the scratch's memory resource. There is
+    // no recovery for bad input: a polygon the sweep finds is not simple
+    // appends nothing and returns 0. With EpsilonKernel that can include
+    // dense floating-point outlines whose near-flat turns test
+    // inconsistently; use ExactKernel for those.
+    template <typename Kernel = EpsilonKernel, typename T, typename Alloc>
+    static size_t triangulateMonotone(const Point<T>* polygon, size_t n, std::vector<uint32_t, Alloc>& indices,
+                                      TriangulationScratch<T>& scratch, uint32_t base = 0) {
+        size_t before = indices.size();
+        uint32_t start = triangulationRing<Kernel>(polygon, n, scratch);
+        if (start == TriangulationNone) return 0;
+        if (!monotoneTriangulate<Kernel>(scratch, start, indices, base)) {
+            indices.resize(before);
+            return 0;
+        }
+        return (indices.size() - before) / 3;
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static std::vector<uint32_t> triangulateMonotone(const std::vector<Point<T>>& polygon) {
+        TriangulationScratch<T> scratch;
+        std::vector<uint32_t> indices;
+        triangulateMonotone<Kernel>(polygon.data(), polygon.size(), indices, scratch);
+        return indices;
+    }
+
+    // Triangulates every polygon of a CSR batch (see "Polygon batches") into
+    // one index buffer in the same form: polygon i's triangles are
+    // indices[indexOffsets[i], indexOffsets[i + 1]), three entries each,
+    // indexing the flat vertex array, so the buffers can go to a renderer
+    // as they are. The vertex array must hold fewer than 2^32 points. Each
+    // block reuses one TriangulationScratch and the per-block outputs are
+    // concatenated at the end.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void triangulateBatch(const Point<T>* vertices, const size_t* offsets, size_t count,
+                                 std::vector<uint32_t>& indices, std::vector<size_t>& indexOffsets,
+                                 TriangulationMethod method = TriangulationMethod::EarClipping,
+                                 const Executor& exec = Executor()) {
+        std::vector<std::vector<uint32_t>> blocks((count + PolygonBatchBlock - 1) / PolygonBatchBlock);
+        indexOffsets.assign(count + 1, 0);
+        forBlocks(count, PolygonBatchBlock, exec, [&](size_t lo, size_t hi) {
+            TriangulationScratch<T> scratch;
+            std::vector<uint32_t>& out = blocks[lo / PolygonBatchBlock];
+            for (size_t i = lo; i < hi; ++i) {
+                const Point<T>* polygon = vertices + offsets[i];
+                size_t n = offsets[i + 1] - offsets[i];
+                size_t triangles = method == TriangulationMethod::Monotone
+                                       ? triangulateMonotone<Kernel>(polygon, n, out, scratch, (uint32_t)offsets[i])
+                                       : triangulate<Kernel>(polygon, n, out, scratch, (uint32_t)offsets[i]);
+                indexOffsets[i + 1] = 3 * triangles;
+            }
+        });
+        for (size_t i = 0; i < count; ++i) indexOffsets[i + 1] += indexOffsets[i];
+        indices.clear();
+        indices.reserve(indexOffsets[count]);
+        for (const auto& b : blocks) indices.insert(indices.end(), b.begin(), b.end());
+    }
+
+    template <typename Kernel = EpsilonKernel, typename T>
+    static void triangulateBatch(const std::vector<Point<T>>& vertices, const std::vector<size_t>& offsets,
+                                 std::vector<uint32_t>& indices, std::vector<size_t>& indexOffsets,
+                                 TriangulationMethod method = TriangulationMethod::EarClipping,
+                                 const Executor& exec = Executor()) {
+        size_t count = offsets.empty() ? 0 : offsets.size() - 1;
+        triangulateBatch<Kernel>(vertices.data(), offsets.data(), count, indices, indexOffsets, method, exec);
+    }
+
+    // ---------------------------------------------------------------------
+    // Incremental hull
+    // ---------------------------------------------------------------------
+
+    // Convex hull of a growing point set. The lower and upper chains live in
+    // balanced trees keyed by x, so insert() is amortized O(log n) (each point
+    // leaves a chain at most once) and contains() is O(log n). snapshot()
+    // lists the vertices in the same order as convexHull(); when the whole set
+    // has fewer than three hull vertices it lists the distinct extremes.
+    template <typename T>
+    class IncrementalHull {
+    public:
+        // Returns true if p changed the hull.
+        bool insert(Point<T> p) {
+            ++inserted;
+            bool changed = lower.insert(p);
+            changed = upper.insert(p) || changed;
+            if (changed) dirty = true;
+            return changed;
+        }
+
+        // Inside or on the boundary.
+        bool contains(Point<T> p) const {
+            return lower.covers(p) && upper.covers(p);
+        }
+
+        size_t insertedCount() const { return inserted; }
+        bool empty() const { return inserted == 0; }
+
+        const std::vector<Point<T>>& snapshot() const {
+            if (dirty) {
+                cache.clear();
+                for (const auto& e : lower.m) cache.emplace_back(e.first, e.second);
+                for (auto it = upper.m.rbegin(); it != upper.m.rend(); ++it) {
+                    Point<T> u(it->first, it->second);
+                    if (u == cache.back() || u == cache.front()) continue;
+                    cache.push_back(u);
+                }
+                cachedDiameter = hullDiameter(cache);
+                dirty = false;
+            }
+            return cache;
+        }
+
+        // Rotating calipers over the hull, kept with the snapshot: O(h) after
+        // an insert that changed the hull, O(1) otherwise.
+        long double diameter() const {
+            snapshot();
+            return cachedDiameter;
+        }
+
+        void clear() {
+            lower.m.clear();
+            upper.m.clear();
+            cache.clear();
+            cachedDiameter = 0;
+            inserted = 0;
+            dirty = false;
+        }
+
+    private:
+        // One x-monotone chain: x -> lowest y (Upper = false) or highest y.
+        // Walking it left to right every turn is strictly counter-clockwise for
+        // the lower chain and strictly clockwise for the upper one.
+        template <bool Upper>
+        struct Chain {
+            std::map<T, T> m;
+            static constexpr int Turn = Upper ? 1 : 2;
+
+            static bool better(T a, T b) { return Upper ? a > b : a < b; }
+            static Point<T> at(typename std::map<T, T>::const_iterator it) { return Point<T>(it->first, it->second); }
+
+            bool insert(Point<T> p) {
+                auto it = m.find(p.x);
+                if (it != m.end()) {
+                    if (!better(p.y, it->second)) return false;
+                    it->second = p.y;
+                } else {
+                    auto next = m.lower_bound(p.x);
+                    if (next != m.end() && next != m.begin() &&
+                        orientation(at(std::prev(next)), p, at(next)) != Turn)
+                        return false;
+                    it = m.emplace_hint(next, p.x, p.y);
+                }
+
+                while (true) {
+                    auto n1 = std::next(it);
+                    if (n1 == m.end() || std::next(n1) == m.end()) break;
+                    if (orientation(p, at(n1), at(std::next(n1))) == Turn) break;
+                    m.erase(n1);
+                }
+                while (it != m.begin() && std::prev(it) != m.begin()) {
+                    auto p1 = std::prev(it);
+                    if (orientation(at(std::prev(p1)), at(p1), p) == Turn) break;
+                    m.erase(p1);
+                }
+                return true;
+            }
+
+            // p is on the inner side of (or on) this chain within its x-range.
+            bool covers(Point<T> p) const {
+                auto it = m.lower_bound(p.x);
+                if (it == m.end()) return false;
+                if (it->first == p.x) return !better(p.y, it->second);
+                if (it == m.begin()) return false;
+                return orientation(at(std::prev(it)), p, at(it)) != Turn;
+            }
+        };
+
+        Chain<false> lower;
+        Chain<true> upper;
+        size_t inserted = 0;
+        mutable std::vector<Point<T>> cache;
+        mutable long double cachedDiameter = 0;
+        mutable bool dirty = false;
+    };
+
+    // ---------------------------------------------------------------------
+    // Editable polygon
+    // ---------------------------------------------------------------------
+
+    // A simple polygon under interactive edits. Vertices have stable ids in a
+    // doubly linked ring, so insertAfter(), move() and erase() are O(1) apart
+    // from the containment index below.
+    //
+    // The shoelace sum is kept relative to a fixed anchor and adjusted by
+    // the few edge terms an edit changes. For floating-point coordinates
+    // it is recomputed after every size() edits to bound rounding drift,
+    // which is still O(1) amortized. The bounding box grows in O(1), and it
+    // is only recomputed, lazily, after an extreme vertex moves inward or is
+    // erased.
+    //
+    // contains() uses a y-band index like PolygonIndex's, built on the first
+    // query. Afterwards an edit only updates the bands spanned by the edges it
+    // changes. The index is dropped, and rebuilt at the next query, after
+    // size() edits or once edits have doubled its band entries. That keeps
+    // the bands balanced as the shape drifts. Answers match
+    // isInside<Kernel>(vertices(), p).
+    template <typename T, typename Kernel = EpsilonKernel>
+    class EditablePolygon {
+    public:
+        static constexpr size_t None = std::numeric_limits<size_t>::max();
+
+        EditablePolygon() = default;
+
+        // Vertex i gets id i.
+        explicit EditablePolygon(const std::vector<Point<T>>& polygon) {
+            size_t n = polygon.size();
+            pts = polygon;
+            nxt.resize(n);
+            prv.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                nxt[i] = i + 1 < n ? i + 1 : 0;
+                prv[i] = i > 0 ? i - 1 : n - 1;
+            }
+            count = n;
+            head = n > 0 ? 0 : None;
+            if (n > 0) anchor = polygon[0];
+            resync();
+        }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        // Some vertex id (the start of vertices()), or None when empty.
+        size_t first() const { return head; }
+        size_t next(size_t v) const { return nxt[v]; }
+        size_t prev(size_t v) const { return prv[v]; }
+        Point<T> point(size_t v) const { return pts[v]; }
+
+        // Inserts p between v and next(v) and returns its id. v is ignored when
+        // the polygon is empty.
+        size_t insertAfter(size_t v, Point<T> p) {
+            size_t u = allocate(p);
+            if (count == 0) {
+                nxt[u] = prv[u] = u;
+                head = u;
+                indexed = false;
+                bands.clear();
+                anchor = p;
+                a2 = 0;
+                box = {p, p};
+                boxDirty = false;
+                count = 1;
+                return u;
+            }
+            size_t w = nxt[v];
+            removeEdge(v);
+            a2 += term(pts[v], p) + term(p, pts[w]) - term(pts[v], pts[w]);
+            nxt[v] = u; prv[u] = v;
+            nxt[u] = w; prv[w] = u;
+            ++count;
+            grow(p);
+            addEdge(v);
+            addEdge(u);
+            edited();
+            return u;
+        }
+
+        void move(size_t v, Point<T> p) {
+            size_t a = prv[v], b = nxt[v];
+            removeEdge(a);
+            removeEdge(v);
+            a2 += term(pts[a], p) + term(p, pts[b]) - term(pts[a], pts[v]) - term(pts[v], pts[b]);
+            shrinks(pts[v]);
+            pts[v] = p;
+            grow(p);
+            addEdge(a);
+            addEdge(v);
+            edited();
+        }
+
+        void erase(size_t v) {
+            size_t a = prv[v], b = nxt[v];
+            removeEdge(a);
+            removeEdge(v);
+            a2 += term(pts[a], pts[b]) - term(pts[a], pts[v]) - term(pts[v], pts[b]);
+            shrinks(pts[v]);
+            nxt[a] = b; prv[b] = a;
+            if (head == v) head = count > 1 ? b : None;
+            unused.push_back(v);
+            if (--count == 0) {
+                // Back to the default-constructed state, as boundingBox() of
+                // no points.
+                a2 = 0;
+                edits = 0;
+                box = {Point<T>(), Point<T>()};
+                boxDirty = false;
+                indexed = false;
+                bands.clear();
+                return;
+            }
+            addEdge(a);
+            edited();
+        }
+
+        // Positive for counter-clockwise order, as polygonSignedArea().
+        Wide<T> signedArea() const { return a2 / 2; }
+        long double area() const { return std::abs((long double)a2 / 2); }
+
+        // All zero when empty, as boundingBox().
+        const BoundingBox<T>& bounds() const {
+            if (count == 0) {
+                box = {Point<T>(), Point<T>()};
+                boxDirty = false;
+            } else if (boxDirty) {
+                box = {pts[head], pts[head]};
+                forEach([&](size_t v) { growBox(box, pts[v]); });
+                boxDirty = false;
+            }
+            return box;
+        }
+
+        // Inside or on the boundary.
+        bool contains(Point<T> p) const {
+            if (count < 3) return false;
+            if (!indexed) buildIndex();
+            bool inside = false;
+            for (size_t e : bands[band(p.y)]) {
+                int c = rayCrossing<Kernel>(pts[e], pts[nxt[e]], p);
+                if (c == 2) return true;
+                inside ^= (c == 1);
+            }
+            return inside;
+        }
+
+        // The vertices in ring order, starting at first().
+        std::vector<Point<T>> vertices() const {
+            std::vector<Point<T>> out;
+            out.reserve(count);
+            forEach([&](size_t v) { out.push_back(pts[v]); });
+            return out;
+        }
+
+    private:
+        std::vector<Point<T>> pts;
+        std::vector<size_t> nxt, prv, unused; // ring links, erased ids for reuse
+        size_t head = None, count = 0;
+        Point<T> anchor;
+        Wide<T> a2 = 0;       // twice the signed area
+        size_t edits = 0;     // since the last full shoelace sum
+        mutable BoundingBox<T> box{Point<T>(), Point<T>()};
+        mutable bool boxDirty = false;
+
+        // Bands over the y-range at build time; edges are named by their
+        // start vertex. Points outside that range fall into the end bands.
+        mutable bool indexed = false;
+        mutable size_t indexEdits = 0, entries = 0, builtEntries = 0;
+        mutable Wide<T> minY = 0, scale = 0;
+        mutable std::vector<std::vector<size_t>> bands;
+
+        template <typename F>
+        void forEach(F&& f) const {
+            if (count == 0) return;
+            size_t v = head;
+            do {
+                f(v);
+                v = nxt[v];
+            } while (v != head);
+        }
+
+        Wide<T> term(Point<T> a, Point<T> b) const {
+            return ((Wide<T>)a.x - anchor.x) * ((Wide<T>)b.y - anchor.y) - ((Wide<T>)b.x - anchor.x) * ((Wide<T>)a.y - anchor.y);
+        }
+
+        size_t allocate(Point<T> p) {
+            if (!unused.empty()) {
+                size_t u = unused.back();
+                unused.pop_back();
+                pts[u] = p;
+                return u;
+            }
+            pts.push_back(p);
+            nxt.push_back(None);
+            prv.push_back(None);
+            return pts.size() - 1;
+        }
+
+        void resync() {
+            a2 = 0;
+            forEach([&](size_t v) { a2 += term(pts[v], pts[nxt[v]]); });
+            edits = 0;
+            boxDirty = count > 0;
+        }
+
+        void edited() {
+            if (std::is_floating_point<T>::value && ++edits > count) resync();
+            if (indexed && (++indexEdits > count || entries > 2 * builtEntries + 16)) {
+                indexed = false;
+                bands.clear();
+            }
+        }
+
+        static void growBox(BoundingBox<T>& b, Point<T> p) {
+            b.min.x = std::min(b.min.x, p.x); b.min.y = std::min(b.min.y, p.y);
+            b.max.x = std::max(b.max.x, p.x); b.max.y = std::max(b.max.y, p.y);
+        }
+
+        void grow(Point<T> p) {
+            if (!boxDirty) growBox(box, p);
+        }
+
+        // A vertex leaving q may pull the box in if q was on it.
+        void shrinks(Point<T> q) {
+            if (q.x == box.min.x || q.x == box.max.x || q.y == box.min.y || q.y == box.max.y) boxDirty = true;
+        }
+
+        size_t band(Wide<T> y) const {
+            Wide<T> f = (y - minY) * scale;
+            return f <= 0 ? 0 : std::min(bands.size() - 1, (size_t)f);
+        }
+
+        void buildIndex() const {
+            const BoundingBox<T>& b = bounds();
+            long double spanSum = 0;
+            forEach([&](size_t v) { spanSum += std::abs((long double)pts[nxt[v]].y - pts[v].y); });
+            Wide<T> height = (Wide<T>)b.max.y - b.min.y;
+            size_t n = spanSum > 0 ? (size_t)std::min<long double>(count, std::max<long double>(1, count * (long double)height / spanSum)) : 1;
+            minY = b.min.y;
+            scale = height > 0 ? (Wide<T>)n / height : 0;
+            bands.assign(n, {});
+            indexed = true;
+            indexEdits = entries = 0;
+            forEach([&](size_t v) { addEdge(v); });
+            builtEntries = entries;
+        }
+
+        void addEdge(size_t v) const {
+            if (!indexed) return;
+            Wide<T> y0 = pts[v].y, y1 = pts[nxt[v]].y;
+            for (size_t i = band(std::min(y0, y1)), e = band(std::max(y0, y1)); i <= e; ++i) bands[i].push_back(v);
+            entries += band(std::max(y0, y1)) - band(std::min(y0, y1)) + 1;
+        }
+
+        void removeEdge(size_t v) const {
+            if (!indexed) return;
+            Wide<T> y0 = pts[v].y, y1 = pts[nxt[v]].y;
+            for (size_t i = band(std::min(y0, y1)), e = band(std::max(y0, y1)); i <= e; ++i) {
+                auto& list = bands[i];
+                auto it = std::find(list.begin(), list.end(), v);
+                if (it != list.end()) {
+                    *it = list.back();
+                    list.pop_back();
+                    --entries;
+                }
+            }
+        }
+    };
+
+    // ---------------------------------------------------------------------
+    // Segment intersection
+    // ---------------------------------------------------------------------
+
+    template <typename T>
+    struct Segment {
+        Point<T> a, b;
+        Segment() {}
+        Segment(Point<T> a, Point<T> b) : a(a), b(b) {}
+    };
+
+    // All pairs (i, j), i < j, of segments that intersect in the sense of
+    // doIntersect (touching and collinear overlap included), each reported
+    // once. Bentley-Ottmann sweep: O((n + k) log n) for k pairs. Endpoint
+    // events are exact and crossing points are located in long double, so for
+    // floating-point input a contact closer than EPS but not actually touching
+    // may go unreported.
+    template <typename T>
+    static std::vector<std::pair<size_t, size_t>> segmentIntersections(const std::vector<Segment<T>>& segments) {
+        std::vector<std::pair<size_t, size_t>> pairs;
+        SegmentSweep<T>(segments.data(), segments.size(), SegmentSweep<T>::Report, &pairs).run();
+        return pairs;
+    }
+
+    // Same sweep as segmentIntersections without storing the pairs.
+    template <typename T>
+    static size_t countSegmentIntersections(const std::vector<Segment<T>>& segments) {
+        return SegmentSweep<T>(segments.data(), segments.size(), SegmentSweep<T>::Count, nullptr).run();
+    }
+
+    // Shamos-Hoey: stops at the first intersecting pair, O(n log n). Handy for
+    // rejecting non-simple polygons (feed it the edges).
+    template <typename T>
+    static bool anySegmentsIntersect(const std::vector<Segment<T>>& segments) {
+        return SegmentSweep<T>(segments.data(), segments.size(), SegmentSweep<T>::Any, nullptr).run() != 0;
+    }
+
+#ifdef COMP_GEOM_2D_STATS
+    // ---------------------------------------------------------------------
+    // Instrumentation
+    // ---------------------------------------------------------------------
+
+    // Counters kept per thread while built with COMP_GEOM_2D_STATS. callStats()
+    // holds the running totals of the calling thread. The StatsCallback
+    // receives the share of one top-level call (convexHull, polygonDiameter,
+    // findClosestPair, ... ; nested calls fold into the outer one). Work that
+    // the parallel variants hand to other threads is counted in those threads'
+    // totals, not in the caller's callback.
+    struct CallStats {
+        uint64_t orientations = 0;     // orientation() and orientationBatch() points
+        uint64_t inCircles = 0;
+        uint64_t culledPoints = 0;     // discarded by the hull prefilter
+        uint64_t hullPops = 0;         // monotone chain backtracking steps
+        uint64_t stripPoints = 0;      // closest pair: points entering a strip
+        uint64_t stripComparisons = 0; // closest pair: pairs compared inside strips
+        uint64_t bufferGrowths = 0;    // working buffers that had to grow; 0 means the call did not allocate for them
+        size_t maxDepth = 0;           // deepest recursion reached
+        double prefilterSeconds = 0, sortSeconds = 0, chainSeconds = 0, recursionSeconds = 0;
+        double seconds = 0;            // wall time of top-level calls
+
+        // This minus an earlier snapshot; maxDepth is kept as is.
+        CallStats since(const CallStats& before) const {
+            CallStats d = *this;
+            d.orientations -= before.orientations;
+            d.inCircles -= before.inCircles;
+            d.culledPoints -= before.culledPoints;
+            d.hullPops -= before.hullPops;
+            d.stripPoints -= before.stripPoints;
+            d.stripComparisons -= before.stripComparisons;
+            d.bufferGrowths -= before.bufferGrowths;
+            d.prefilterSeconds -= before.prefilterSeconds;
+            d.sortSeconds -= before.sortSeconds;
+            d.chainSeconds -= before.chainSeconds;
+            d.recursionSeconds -= before.recursionSeconds;
+            d.seconds -= before.seconds;
+            return d;
+        }
+    };
+
+    using StatsCallback = std::function<void(const char* algorithm, const CallStats& call)>;
+
+    static CallStats& callStats() {
+        thread_local CallStats stats;
+        return stats;
+    }
+
+    static void resetCallStats() { callStats() = CallStats(); }
+
+    // Install before starting worker threads; an empty callback disables it.
+    static void setStatsCallback(StatsCallback callback) { statsCallback() = std::move(callback); }
+
+    // Hook objects behind the COMP_GEOM_2D_* macros.
+    class StatsScope {
+    public:
+        explicit StatsScope(const char* name) : name(name), outer(nesting()++ == 0) {
+            if (!outer) return;
+            before = callStats();
+            callStats().maxDepth = 0;
+            start = std::chrono::steady_clock::now();
+        }
+        ~StatsScope() {
+            --nesting();
+            if (!outer) return;
+            CallStats& total = callStats();
+            total.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            CallStats call = total.since(before);
+            total.maxDepth = std::max(total.maxDepth, before.maxDepth);
+            if (statsCallback()) statsCallback()(name, call);
+        }
+
+    private:
+        const char* name;
+        bool outer;
+        CallStats before;
+        std::chrono::steady_clock::time_point start;
+
+        static int& nesting() {
+            thread_local int n = 0;
+            return n;
+        }
+    };
+
+    class PhaseTimer {
+    public:
+        explicit PhaseTimer(double& seconds) : seconds(seconds), start(std::chrono::steady_clock::now()) {}
+        ~PhaseTimer() { seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+
+    private:
+        double& seconds;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    class DepthScope {
+    public:
+        DepthScope() { callStats().maxDepth = std::max(callStats().maxDepth, ++depth()); }
+        ~DepthScope() { --depth(); }
+
+    private:
+        static size_t& depth() {
+            thread_local size_t d = 0;
+            return d;
+        }
+    };
+
+    template <typename Buffer>
+    class GrowthTracker {
+    public:
+        explicit GrowthTracker(const Buffer& buffer) : buffer(buffer), capacity(buffer.capacity()) {}
+        ~GrowthTracker() { callStats().bufferGrowths += buffer.capacity() != capacity; }
+
+    private:
+        const Buffer& buffer;
+        size_t capacity;
+    };
+
+private:
+    static StatsCallback& statsCallback() {
+        static StatsCallback callback;
+        return callback;
+    }
+
+public:
+#endif
+
+private:
+
+    static constexpr size_t PolygonBatchBlock = 256; // polygons per task in the CSR batch functions
+    static constexpr size_t TextChunk = 1 << 14;       // points per formatted write in writePointsText
+    static constexpr char PointFileMagic[8] = {'C', 'G', '2', 'D', 'P', 'T', 'S', 0};
+
+    // Byte position of the CSR offsets in a point file: after the records,
+    // rounded up to 8.
+    template <typename T>
+    static constexpr uint64_t offsetsStart(uint64_t count) {
+        return (sizeof(PointFileHeader) + count * sizeof(Point<T>) + 7) / 8 * 8;
+    }
+
+    template <typename T>
+    static bool writePointFile(const char* path, const Point<T>* points, size_t n, const size_t* offsets, size_t polygons) {
+        static_assert(coordTag<T>() != 0, "point files hold int32, int64, float or double coordinates");
+        PointFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, PointFileMagic, sizeof(header.magic));
+        header.version = 1;
+        header.type = coordTag<T>();
+        header.count = n;
+        header.polygons = polygons;
+        BoundingBox<T> box{Point<T>(), Point<T>()};
+        if (n) {
+            box = {points[0], points[0]};
+            for (size_t i = 1; i < n; ++i) {
+                box.min.x = std::min(box.min.x, points[i].x);
+                box.min.y = std::min(box.min.y, points[i].y);
+                box.max.x = std::max(box.max.x, points[i].x);
+                box.max.y = std::max(box.max.y, points[i].y);
+            }
+        }
+        std::memcpy(header.box, &box, sizeof(box));
+
+        std::FILE* f = std::fopen(path, "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 && (n == 0 || std::fwrite(points, sizeof(Point<T>), n, f) == n);
+        if (ok && polygons) {
+            static const char zeros[8] = {};
+            size_t pad = offsetsStart<T>(n) - sizeof(header) - n * sizeof(Point<T>);
+            ok = std::fwrite(zeros, 1, pad, f) == pad;
+            for (size_t i = 0; ok && i <= polygons; ++i) {
+                uint64_t o = offsets[i];
+                ok = std::fwrite(&o, sizeof(o), 1, f) == 1;
+            }
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+
+    // Calls f(lo, hi) over [0, m) in blocks of `block`, on exec when one is
+    // given and on the calling thread otherwise.
+    template <typename F>
+    static void forBlocks(size_t m, size_t block, const Executor& exec, F&& f) {
+        size_t blocks = (m + block - 1) / block;
+        auto task = [&](size_t b) { f(b * block, std::min(m, (b + 1) * block)); };
+        if (exec) exec(blocks, task);
+        else for (size_t b = 0; b < blocks; ++b) task(b);
+    }
+
+    // Position of (x, y) along the Hilbert curve over the 2^Order x 2^Order
+    // grid; x and y must be below 2^Order.
+    template <unsigned Order = 32>
+    static uint64_t hilbertKey(uint32_t x, uint32_t y) {
+        uint64_t d = 0;
+        for (unsigned k = Order; k-- > 0;) {
+            uint32_t rx = (x >> k) & 1, ry = (y >> k) & 1;
+            d += (uint64_t)((3 * rx) ^ ry) << (2 * k);
+            // Rotate the quadrant, branch-free: flip when rx && !ry, swap when !ry.
+            uint32_t flip = 0u - (rx & (ry ^ 1)), swap = (x ^ y) & (0u - (ry ^ 1));
+            x ^= flip ^ swap;
+            y ^= flip ^ swap;
+        }
+        return d;
+    }
+
+    // Bits of x and y interleaved, x in the even positions.
+    static uint64_t mortonKey(uint32_t x, uint32_t y) {
+        auto spread = [](uint64_t v) {
+            v = (v | v << 16) & 0x0000FFFF0000FFFFull;
+            v = (v | v << 8) & 0x00FF00FF00FF00FFull;
+            v = (v | v << 4) & 0x0F0F0F0F0F0F0F0Full;
+            v = (v | v << 2) & 0x3333333333333333ull;
+            return (v | v << 1) & 0x5555555555555555ull;
+        };
+        return spread(x) | spread(y) << 1;
+    }
+
+    static constexpr unsigned CurveOrder = 16;       // grid bits per axis for spatialSort
+    static constexpr size_t CurveBlock = 1 << 16;    // points per task in the spatialSort passes
+
+    struct CurveEntry {
+        uint64_t key;
+        size_t index;
+    };
+
+    // Curve key of every point, sorted by key. tasks > 1 runs the bounding box,
+    // the keys and the radix passes on exec.
+    template <typename T>
+    static std::vector<CurveEntry> curveEntries(const Point<T>* points, size_t n, SpaceCurve curve, const Executor& exec,
+                                                size_t tasks) {
+        tasks = std::min(tasks, n / CurveBlock);
+        std::vector<CurveEntry> entries(n), buffer(n);
+        if (n == 0) return entries;
+
+        BoundingBox<T> box;
+        if (tasks > 1) {
+            std::vector<BoundingBox<T>> boxes(tasks);
+            exec(tasks, [&](size_t t) {
+                size_t lo = n * t / tasks;
+                boxes[t] = boundingBox(points + lo, n * (t + 1) / tasks - lo);
+            });
+            box = boxes[0];
+            for (const BoundingBox<T>& b : boxes) {
+                box.min.x = std::min(box.min.x, b.min.x); box.min.y = std::min(box.min.y, b.min.y);
+                box.max.x = std::max(box.max.x, b.max.x); box.max.y = std::max(box.max.y, b.max.y);
+            }
+        } else {
+            box = boundingBox(points, n);
+        }
+
+        constexpr double Cells = double((1u << CurveOrder) - 1);
+        double extent = std::max((double)box.max.x - (double)box.min.x, (double)box.max.y - (double)box.min.y);
+        double scale = extent > 0 ? Cells / extent : 0;
+        double x0 = (double)box.min.x, y0 = (double)box.min.y;
+        auto cellX = [=](T x) { return (uint32_t)std::min(Cells, ((double)x - x0) * scale); };
+        auto cellY = [=](T y) { return (uint32_t)std::min(Cells, ((double)y - y0) * scale); };
+        auto keys = [&](size_t lo, size_t hi) {
+            if (curve == SpaceCurve::Hilbert)
+                for (size_t i = lo; i < hi; ++i) entries[i] = {hilbertKey<CurveOrder>(cellX(points[i].x), cellY(points[i].y)), i};
+            else
+                for (size_t i = lo; i < hi; ++i) entries[i] = {mortonKey(cellX(points[i].x), cellY(points[i].y)), i};
+        };
+        auto word = [](const CurveEntry& e) { return e.key; };
+        if (tasks > 1) {
+            exec(tasks, [&](size_t t) { keys(n * t / tasks, n * (t + 1) / tasks); });
+            radixSortWordsParallel(entries.data(), n, buffer.data(), word, exec, tasks);
+        } else {
+            keys(0, n);
+            radixSortWords(entries.data(), n, buffer.data(), word);
+        }
+        return entries;
+    }
+
+    // Twice the signed area, positive for counter-clockwise.
+    template <typename T, typename Alloc>
+    static Wide<T> signedArea2(const std::vector<Point<T>, Alloc>& ring) {
+        Wide<T> sum = 0;
+        size_t n = ring.size();
+        for (size_t i = 0; i < n; ++i) {
+            const Point<T>& a = ring[i];
+            const Point<T>& b = ring[i + 1 < n ? i + 1 : 0];
+            sum += (Wide<T>)a.x * b.y - (Wide<T>)b.x * a.y;
+        }
+        return sum;
+    }
+
+    // Intersection of segment p-q with the line through a, b (assumed to cross).
+    template <typename W>
+    static Point<W> lineIntersection(const Point<W>& p, const Point<W>& q, const Point<W>& a, const Point<W>& b) {
+        W dx = b.x - a.x, dy = b.y - a.y;
+        W cp = dx * (p.y - a.y) - dy * (p.x - a.x);
+        W cq = dx * (q.y - a.y) - dy * (q.x - a.x);
+        W t = cp / (cp - cq);
+        return {p.x + t * (q.x - p.x), p.y + t * (q.y - p.y)};
+    }
+
+    // Copies a working ring to output coordinates, rounding for integral T and
+    // dropping consecutive repeats.
+    template <typename W, typename Alloc, typename T, typename OutAlloc>
+    static void emitRing(const std::vector<Point<W>, Alloc>& ring, std::vector<Point<T>, OutAlloc>& out) {
+        out.clear();
+        for (const Point<W>& p : ring) {
+            Point<T> q;
+            if constexpr (std::is_integral<T>::value) q = {(T)std::llround(p.x), (T)std::llround(p.y)};
+            else q = {(T)p.x, (T)p.y};
+            if (out.empty() || !(out.back() == q)) out.push_back(q);
+        }
+        while (out.size() > 1 && out.back() == out.front()) out.pop_back();
+        if (out.size() < 3) out.clear();
+    }
+
+    // Collects all proper crossings between the two working rings. Returns
+    // false on a degenerate contact (a vertex on the other ring, or
+    // overlapping collinear edges), which Greiner-Hormann cannot label.
+    template <typename T>
+    static bool findCrossings(ClipScratch<T>& scratch) {
+        using W = Wide<T>;
+        const auto& S = scratch.subject;
+        const auto& C = scratch.clip;
+        size_t n = S.size(), m = C.size();
+        scratch.crossings.clear();
+        for (size_t i = 0; i < n; ++i) {
+            const Point<W>& p0 = S[i];
+            const Point<W>& p1 = S[i + 1 < n ? i + 1 : 0];
+            W pxlo = std::min(p0.x, p1.x), pxhi = std::max(p0.x, p1.x);
+            W pylo = std::min(p0.y, p1.y), pyhi = std::max(p0.y, p1.y);
+            for (size_t j = 0; j < m; ++j) {
+                const Point<W>& q0 = C[j];
+                const Point<W>& q1 = C[j + 1 < m ? j + 1 : 0];
+                if (std::max(q0.x, q1.x) < pxlo || std::min(q0.x, q1.x) > pxhi ||
+                    std::max(q0.y, q1.y) < pylo || std::min(q0.y, q1.y) > pyhi)
+                    continue;
+                int o1 = orientation<ExactKernel>(p0, p1, q0), o2 = orientation<ExactKernel>(p0, p1, q1);
+                int o3 = orientation<ExactKernel>(q0, q1, p0), o4 = orientation<ExactKernel>(q0, q1, p1);
+                if (o1 == 0 && onSegment(p0, q0, p1)) return false;
+                if (o2 == 0 && onSegment(p0, q1, p1)) return false;
+                if (o3 == 0 && onSegment(q0, p0, q1)) return false;
+                if (o4 == 0 && onSegment(q0, p1, q1)) return false;
+                if (o1 == o2 || o3 == o4) continue;
+
+                W dpx = p1.x - p0.x, dpy = p1.y - p0.y, dqx = q1.x - q0.x, dqy = q1.y - q0.y;
+                W den = dpx * dqy - dpy * dqx;
+                W s = ((q0.x - p0.x) * dqy - (q0.y - p0.y) * dqx) / den;
+                W t = ((q0.x - p0.x) * dpy - (q0.y - p0.y) * dpx) / den;
+                s = std::min<W>(std::max<W>(s, 0), 1);
+                t = std::min<W>(std::max<W>(t, 0), 1);
+                scratch.crossings.push_back({i, j, s, t, {p0.x + s * dpx, p0.y + s * dpy}, 0, 0});
+            }
+        }
+        return true;
+    }
+
+    // Builds one ring's node list: vertex k followed by the crossings on edge
+    // k in order along it. Crossing nodes record their position in the list.
+    template <typename T, typename EdgeOf, typename ParamOf, typename SlotOf>
+    static void buildClipNodes(const std::pmr::vector<Point<Wide<T>>>& ring, ClipScratch<T>& scratch, std::pmr::vector<ClipNode<T>>& nodes,
+                               EdgeOf edgeOf, ParamOf paramOf, SlotOf slotOf) {
+        auto& order = scratch.order;
+        auto& xs = scratch.crossings;
+        order.resize(xs.size());
+        for (size_t k = 0; k < xs.size(); ++k) order[k] = k;
+        std::sort(order.begin(), order.end(), [&](size_t u, size_t v) {
+            return edgeOf(xs[u]) != edgeOf(xs[v]) ? edgeOf(xs[u]) < edgeOf(xs[v]) : paramOf(xs[u]) < paramOf(xs[v]);
+        });
+        nodes.clear();
+        size_t k = 0;
+        for (size_t v = 0; v < ring.size(); ++v) {
+            nodes.push_back({ring[v], 0, 0, 0, false, false, false});
+            for (; k < order.size() && edgeOf(xs[order[k]]) == v; ++k) {
+                slotOf(xs[order[k]]) = nodes.size();
+                nodes.push_back({xs[order[k]].p, 0, 0, order[k], true, false, false});
+            }
+        }
+        size_t count = nodes.size();
+        for (size_t v = 0; v < count; ++v) {
+            nodes[v].next = v + 1 < count ? v + 1 : 0;
+            nodes[v].prev = v > 0 ? v - 1 : count - 1;
+        }
+    }
+
+    template <typename T>
+    static void greinerHormann(BooleanOp op, std::vector<std::vector<Point<T>>>& out, ClipScratch<T>& scratch, Wide<T> sliver) {
+        using W = Wide<T>;
+        const auto& S = scratch.subject;
+        const auto& C = scratch.clip;
+        auto& sn = scratch.subjectNodes;
+        auto& cn = scratch.clipNodes;
+
+        bool subjectInClip = isInside<ExactKernel>(C.data(), C.size(), S[0]);
+        bool clipInSubject = isInside<ExactKernel>(S.data(), S.size(), C[0]);
+        if (scratch.crossings.empty()) {
+            auto emit = [&](const std::pmr::vector<Point<W>>& ring, bool reversed) {
+                out.emplace_back();
+                emitRing(ring, out.back());
+                if (reversed) std::reverse(out.back().begin(), out.back().end());
+                if (out.back().empty()) out.pop_back();
+            };
+            switch (op) {
+            case BooleanOp::Intersection:
+                if (subjectInClip) emit(S, false);
+                else if (clipInSubject) emit(C, false);
+                break;
+            case BooleanOp::Union:
+                if (subjectInClip) emit(C, false);
+                else if (clipInSubject) emit(S, false);
+                else emit(S, false), emit(C, false);
+                break;
+            case BooleanOp::Difference:
+                if (subjectInClip) break;
+                emit(S, false);
+                if (clipInSubject) emit(C, true); // hole
+                break;
+            }
+            return;
+        }
+
+        buildClipNodes(S, scratch, sn, [](const ClipCrossing<T>& x) { return x.i; }, [](const ClipCrossing<T>& x) { return x.s; },
+                       [](ClipCrossing<T>& x) -> size_t& { return x.subjectNode; });
+        buildClipNodes(C, scratch, cn, [](const ClipCrossing<T>& x) { return x.j; }, [](const ClipCrossing<T>& x) { return x.t; },
+                       [](ClipCrossing<T>& x) -> size_t& { return x.clipNode; });
+        for (auto& node : sn)
+            if (node.crossing) node.twin = scratch.crossings[node.twin].clipNode;
+        for (auto& node : cn)
+            if (node.crossing) node.twin = scratch.crossings[node.twin].subjectNode;
+
+        // Entry / exit labels; flipping them selects the other side of each
+        // polygon: union keeps both outsides, difference the subject outside.
+        auto label = [](std::pmr::vector<ClipNode<T>>& nodes, bool inside, bool flip) {
+            for (auto& node : nodes) {
+                if (!node.crossing) continue;
+                node.entry = !inside != flip;
+                inside = !inside;
+            }
+        };
+        label(sn, subjectInClip, op != BooleanOp::Intersection);
+        label(cn, clipInSubject, op == BooleanOp::Union);
+
+        std::pmr::vector<Point<W>>& ring = scratch.ping;
+        for (size_t start = 0; start < sn.size(); ++start) {
+            if (!sn[start].crossing || sn[start].visited) continue;
+            ring.clear();
+            bool onSubject = true;
+            size_t cur = start;
+            ring.push_back(sn[cur].p);
+            while (true) {
+                auto& list = onSubject ? sn : cn;
+                list[cur].visited = true;
+                (onSubject ? cn : sn)[list[cur].twin].visited = true;
+                bool forward = list[cur].entry;
+                do {
+                    cur = forward ? list[cur].next : list[cur].prev;
+                    ring.push_back(list[cur].p);
+                } while (!list[cur].crossing);
+                list[cur].visited = true;
+                cur = list[cur].twin;
+                onSubject = !onSubject;
+                if ((onSubject ? sn : cn)[cur].visited) break;
+            }
+            ring.pop_back(); // closing point repeats the start
+            // Each ring keeps the result on one side; starting backwards puts
+            // it on the right, so flip those to get outers CCW and holes CW.
+            if (!sn[start].entry) std::reverse(ring.begin(), ring.end());
+            if (std::abs(signedArea2(ring)) <= sliver) continue;
+            out.emplace_back();
+            emitRing(ring, out.back());
+            if (out.back().empty()) out.pop_back();
+        }
+    }
+
+    static constexpr uint32_t TriangulationNone = std::numeric_limits<uint32_t>::max();
+    static constexpr size_t EarIndexThreshold = 80; // vertices above which the ear test uses the z-order index
+    static constexpr unsigned EarGridBits = 15;      // cells per axis of the ear index: 2^15
+    static constexpr size_t EarLeafEntries = 16;      // index runs checked entry by entry
+
+    // Cell grid of the z-order ear index over the polygon's bounding box,
+    // scaled per axis so long thin polygons still get 2^15 cells across;
+    // hashed is false below EarIndexThreshold.
+    struct EarGrid {
+        double minX = 0, minY = 0, invX = 0, invY = 0;
+        bool hashed = false;
+
+        template <typename T>
+        Point<double> cell(const Point<T>& p) const {
+            return {((double)p.x - minX) * invX, ((double)p.y - minY) * invY};
+        }
+
+        template <typename T>
+        uint64_t key(const Point<T>& p) const {
+            Point<double> c = cell(p);
+            return mortonKey((uint32_t)c.x, (uint32_t)c.y);
+        }
+    };
+
+    // Links polygon[0, n) into scratch.nodes as a counter-clockwise ring and
+    // drops repeated and collinear vertices. Returns a node on the ring, or
+    // TriangulationNone when fewer than three vertices remain.
+    template <typename Kernel, typename T>
+    static uint32_t triangulationRing(const Point<T>* polygon, size_t n, TriangulationScratch<T>& scratch) {
+        auto& N = scratch.nodes;
+        N.clear();
+        if (n < 3) return TriangulationNone;
+        bool ccw = polygonSignedArea(polygon, n) >= 0;
+        N.resize(n);
+        for (size_t k = 0; k < n; ++k) {
+            uint32_t i = (uint32_t)(ccw ? k : n - 1 - k);
+            N[k] = {polygon[i], i, (uint32_t)(k ? k - 1 : n - 1), (uint32_t)(k + 1 < n ? k + 1 : 0), false};
+        }
+        uint32_t start = filterRing<Kernel>(N, 0, 0);
+        return N[start].next == N[start].prev ? TriangulationNone : start;
+    }
+
+    template <typename T>
+    static void unlinkNode(std::pmr::vector<TriangulationNode<T>>& N, uint32_t p) {
+        N[N[p].next].prev = N[p].prev;
+        N[N[p].prev].next = N[p].next;
+        N[p].removed = true;
+    }
+
+    template <typename Kernel, typename T>
+    static int nodeTurn(const std::pmr::vector<TriangulationNode<T>>& N, uint32_t a, uint32_t b, uint32_t c) {
+        return orientation<Kernel>(N[a].p, N[b].p, N[c].p);
+    }
+
+    // Removes repeated and collinear vertices, starting at start and walking
+    // until end is reached with nothing left to remove; a spike folds away
+    // entirely. Returns a node still on the ring.
+    template <typename Kernel, typename T>
+    static uint32_t filterRing(std::pmr::vector<TriangulationNode<T>>& N, uint32_t start, uint32_t end) {
+        uint32_t p = start;
+        bool again;
+        do {
+            again = false;
+            if (N[p].p == N[N[p].next].p || nodeTurn<Kernel>(N, N[p].prev, p, N[p].next) == 0) {
+                unlinkNode(N, p);
+                p = end = N[p].prev;
+                if (p == N[p].next) break;
+                again = true;
+            } else {
+                p = N[p].next;
+            }
+        } while (again || p != end);
+        return end;
+    }
+
+    template <typename Alloc>
+    static void emitTriangle(std::vector<uint32_t, Alloc>& out, uint32_t base, uint32_t a, uint32_t b, uint32_t c) {
+        out.push_back(base + a);
+        out.push_back(base + b);
+        out.push_back(base + c);
+    }
+
+    // Whether q lies in the closed counter-clockwise triangle a, b, c, whose
+    // bounding box is x0, y0, x1, y1.
+    template <typename Kernel, typename T>
+    static bool inEarTriangle(const Point<T>& q, const Point<T>& a, const Point<T>& b, const Point<T>& c, T x0, T y0,
+                              T x1, T y1) {
+        return q.x >= x0 && q.x <= x1 && q.y >= y0 && q.y <= y1 && orientation<Kernel>(a, b, q) != 1 &&
+               orientation<Kernel>(b, c, q) != 1 && orientation<Kernel>(c, a, q) != 1;
+    }
+
+    // Ear test by walking the rest of the ring. Only a reflex vertex can
+    // block an ear of a simple polygon: the ring cannot cross a-b or b-c, so
+    // a stretch of it entering the triangle turns back inside it, and does
+    // so at a reflex vertex.
+    template <typename Kernel, typename T>
+    static bool isEar(const std::pmr::vector<TriangulationNode<T>>& N, uint32_t ear) {
+        uint32_t ia = N[ear].prev, ic = N[ear].next;
+        const Point<T>& a = N[ia].p, & b = N[ear].p, & c = N[ic].p;
+        if (orientation<Kernel>(a, b, c) != 2) return false;
+        T x0 = std::min({a.x, b.x, c.x}), y0 = std::min({a.y, b.y, c.y});
+        T x1 = std::max({a.x, b.x, c.x}), y1 = std::max({a.y, b.y, c.y});
+        for (uint32_t p = N[ic].next; p != ia; p = N[p].next)
+            if (inEarTriangle<Kernel>(N[p].p, a, b, c, x0, y0, x1, y1) && nodeTurn<Kernel>(N, N[p].prev, p, N[p].next) == 1)
+                return false;
+        return true;
+    }
+
+    // Ear test through the z-order index, walked as the quadtree the Morton
+    // order encodes: each quadrant's entries are one contiguous run, so the
+    // walk starts at the smallest quadrant holding the triangle's bounding
+    // box, drops quadrants clear of the triangle and checks runs of at most
+    // EarLeafEntries entry by entry. Long thin ears then only visit cells
+    // near them. Entries for clipped vertices and for vertices that are no
+    // longer reflex are counted in stale and skipped.
+    template <typename Kernel, typename T>
+    static bool isEarIndexed(const TriangulationScratch<T>& s, uint32_t ear, const EarGrid& grid, size_t& stale) {
+        const auto& N = s.nodes;
+        uint32_t ia = N[ear].prev, ic = N[ear].next;
+        const Point<T>& a = N[ia].p, & b = N[ear].p, & c = N[ic].p;
+        if (orientation<Kernel>(a, b, c) != 2) return false;
+        T x0 = std::min({a.x, b.x, c.x}), y0 = std::min({a.y, b.y, c.y});
+        T x1 = std::max({a.x, b.x, c.x}), y1 = std::max({a.y, b.y, c.y});
+
+        // The triangle in cell units. Quadrants are tested padded by a cell,
+        // so rounding in the mapping cannot prune a vertex the exact test
+        // would catch.
+        Point<double> tri[3] = {grid.cell(a), grid.cell(b), grid.cell(c)};
+        Point<double> lo = grid.cell(Point<T>(x0, y0)), hi = grid.cell(Point<T>(x1, y1));
+        auto clear = [&](double qx0, double qy0, double qx1, double qy1) {
+            if (qx1 < lo.x || qx0 > hi.x || qy1 < lo.y || qy0 > hi.y) return true;
+            for (int e = 0; e < 3; ++e) {
+                const Point<double>& p = tri[e], & q = tri[e == 2 ? 0 : e + 1];
+                auto right = [&](double x, double y) { return (q.x - p.x) * (y - p.y) - (q.y - p.y) * (x - p.x) < 0; };
+                if (right(qx0, qy0) && right(qx1, qy0) && right(qx0, qy1) && right(qx1, qy1)) return true;
+            }
+            return false;
+        };
+        auto check = [&](uint64_t entry) {
+            uint32_t p = (uint32_t)entry;
+            if (p == ia || p == ic || p == ear) return false;
+            if (N[p].removed || nodeTurn<Kernel>(N, N[p].prev, p, N[p].next) != 1) {
+                ++stale;
+                return false;
+            }
+            return inEarTriangle<Kernel>(N[p].p, a, b, c, x0, y0, x1, y1);
+        };
+        using It = typename std::pmr::vector<uint64_t>::const_iterator;
+        // Whether an entry of quadrant (ox, oy) of side 2^level, holding
+        // entries [first, last), blocks the ear.
+        auto blocked = [&](auto& self, uint32_t ox, uint32_t oy, unsigned level, It first, It last) -> bool {
+            if (first == last) return false;
+            uint32_t side = 1u << level;
+            if (clear((double)ox - 1, (double)oy - 1, (double)ox + side + 1, (double)oy + side + 1)) return false;
+            if ((size_t)(last - first) <= EarLeafEntries || level == 0) {
+                for (It it = first; it != last; ++it)
+                    if (check(*it)) return true;
+                return false;
+            }
+            uint32_t half = side / 2;
+            uint64_t start = mortonKey(ox, oy), quarter = (uint64_t)half * half;
+            for (uint32_t q = 0; q < 4; ++q) {
+                It end = q == 3 ? last : std::lower_bound(first, last, (start + (q + 1) * quarter) << 32);
+                if (self(self, ox + (q & 1) * half, oy + (q >> 1) * half, level - 1, first, end)) return true;
+                first = end;
+            }
+            return false;
+        };
+        uint32_t cx0 = (uint32_t)lo.x, cy0 = (uint32_t)lo.y, cx1 = (uint32_t)hi.x, cy1 = (uint32_t)hi.y;
+        unsigned level = 0;
+        while (((cx0 ^ cx1) | (cy0 ^ cy1)) >> level) ++level;
+        uint32_t ox = cx0 >> level << level, oy = cy0 >> level << level;
+        uint64_t first = mortonKey(ox, oy), count = (uint64_t)1 << (2 * level);
+        It from = std::lower_bound(s.reflex.begin(), s.reflex.end(), first << 32);
+        It to = std::lower_bound(from, s.reflex.end(), (first + count) << 32);
+        return !blocked(blocked, ox, oy, level, from, to);
+    }
+
+    // Builds the z-order index from the reflex vertices of the ring through
+    // start. Clipping an ear only turns its neighbours convex or flat, so
+    // entries go stale but none go missing.
+    template <typename Kernel, typename T>
+    static void indexReflex(TriangulationScratch<T>& s, uint32_t start, const EarGrid& grid) {
+        const auto& N = s.nodes;
+        s.reflex.clear();
+        uint32_t p = start;
+        do {
+            if (nodeTurn<Kernel>(N, N[p].prev, p, N[p].next) == 1) s.reflex.push_back(grid.key(N[p].p) << 32 | p);
+            p = N[p].next;
+        } while (p != start);
+        std::sort(s.reflex.begin(), s.reflex.end());
+    }
+
+    // Drops the stale entries of the z-order index. Keys do not change, so
+    // the survivors stay sorted.
+    template <typename Kernel, typename T>
+    static void pruneReflex(TriangulationScratch<T>& s) {
+        const auto& N = s.nodes;
+        s.reflex.erase(std::remove_if(s.reflex.begin(), s.reflex.end(),
+                                      [&](uint64_t entry) {
+                                          uint32_t p = (uint32_t)entry;
+                                          return N[p].removed || nodeTurn<Kernel>(N, N[p].prev, p, N[p].next) != 1;
+                                      }),
+                       s.reflex.end());
+    }
+
+    // Earcut's main loop (Mapbox earcut, ISC): clip ears around the ring;
+    // when a full lap finds none, pass 0 filters the ring and retries, pass
+    // 1 also cures local self-intersections, pass 2 splits the ring in two
+    // along a valid diagonal and starts over on each half.
+    template <typename Kernel, typename T, typename Alloc>
+    static void earClip(TriangulationScratch<T>& s, uint32_t ear, std::vector<uint32_t, Alloc>& out, uint32_t base,
+                        const EarGrid& grid, int pass) {
+        auto& N = s.nodes;
+        if (N[ear].prev == N[ear].next) return;
+        if (grid.hashed) indexReflex<Kernel>(s, ear, grid);
+        size_t stale = 0;
+        uint32_t stop = ear, retryNext = TriangulationNone, retryPrev = TriangulationNone;
+        while (N[ear].prev != N[ear].next) {
+            uint32_t prev = N[ear].prev, next = N[ear].next;
+            // Pruning costs one pass over the index, paid for by the scans
+            // that stepped over at least as many stale entries.
+            if (stale > s.reflex.size()) {
+                pruneReflex<Kernel>(s);
+                stale = 0;
+            }
+            if (grid.hashed ? isEarIndexed<Kernel>(s, ear, grid, stale) : isEar<Kernel>(N, ear)) {
+                emitTriangle(out, base, N[prev].i, N[ear].i, N[next].i);
+                unlinkNode(N, ear);
+                // Skipping the next vertex leaves fewer slivers.
+                retryNext = next;
+                retryPrev = prev;
+                ear = stop = N[next].next;
+                continue;
+            }
+            // The clipped ear's neighbours are the vertices whose angles just
+            // shrank: try them before walking on, so that ears marching along
+            // a strip or past a run of flat vertices don't cost a lap each.
+            uint32_t& retry = retryNext != TriangulationNone ? retryNext : retryPrev;
+            if (retry != TriangulationNone) {
+                ear = stop = retry;
+                retry = TriangulationNone;
+                continue;
+            }
+            ear = next;
+            if (ear == stop) {
+                if (pass == 0) {
+                    earClip<Kernel>(s, filterRing<Kernel>(N, ear, ear), out, base, grid, 1);
+                } else if (pass == 1) {
+                    uint32_t cured = cureLocalIntersections<Kernel>(N, filterRing<Kernel>(N, ear, ear), out, base);
+                    earClip<Kernel>(s, cured, out, base, grid, 2);
+                } else {
+                    splitEarClip<Kernel>(s, ear, out, base, grid);
+                }
+                break;
+            }
+        }
+    }
+
+    // Clips a - p - p.next - b where edges a-p and p.next-b cross, a local
+    // self-intersection, as the triangle a, p, b.
+    template <typename Kernel, typename T, typename Alloc>
+    static uint32_t cureLocalIntersections(std::pmr::vector<TriangulationNode<T>>& N, uint32_t start,
+                                           std::vector<uint32_t, Alloc>& out, uint32_t base) {
+        uint32_t p = start;
+        do {
+            uint32_t a = N[p].prev, pn = N[p].next, b = N[pn].next;
+            if (!(N[a].p == N[b].p) && doIntersect<Kernel>(N[a].p, N[p].p, N[pn].p, N[b].p) &&
+                locallyInside<Kernel>(N, a, b) && locallyInside<Kernel>(N, b, a)) {
+                emitTriangle(out, base, N[a].i, N[p].i, N[b].i);
+                unlinkNode(N, p);
+                unlinkNode(N, pn);
+                p = start = b;
+            }
+            p = N[p].next;
+        } while (p != start);
+        return filterRing<Kernel>(N, p, p);
+    }
+
+    template <typename Kernel, typename T, typename Alloc>
+    static void splitEarClip(TriangulationScratch<T>& s, uint32_t start, std::vector<uint32_t, Alloc>& out,
+                             uint32_t base, const EarGrid& grid) {
+        auto& N = s.nodes;
+        uint32_t a = start;
+        do {
+            for (uint32_t b = N[N[a].next].next; b != N[a].prev; b = N[b].next) {
+                if (N[a].i != N[b].i && isValidDiagonal<Kernel>(N, a, b)) {
+                    uint32_t c = splitRing(N, a, b);
+                    a = filterRing<Kernel>(N, a, N[a].next);
+                    c = filterRing<Kernel>(N, c, N[c].next);
+                    earClip<Kernel>(s, a, out, base, grid, 0);
+                    earClip<Kernel>(s, c, out, base, grid, 0);
+                    return;
+                }
+            }
+            a = N[a].next;
+        } while (a != start);
+    }
+
+    // Whether a - b runs inside the ring without crossing it.
+    template <typename Kernel, typename T>
+    static bool isValidDiagonal(const std::pmr::vector<TriangulationNode<T>>& N, uint32_t a, uint32_t b) {
+        if (N[N[a].next].i == N[b].i || N[N[a].prev].i == N[b].i) return false;
+        uint32_t p = a;
+        do {
+            uint32_t q = N[p].next;
+            if (N[p].i != N[a].i && N[q].i != N[a].i && N[p].i != N[b].i && N[q].i != N[b].i &&
+                doIntersect<Kernel>(N[p].p, N[q].p, N[a].p, N[b].p))
+                return false;
+            p = q;
+        } while (p != a);
+        if (locallyInside<Kernel>(N, a, b) && locallyInside<Kernel>(N, b, a) && middleInside(N, a, b) &&
+            (nodeTurn<Kernel>(N, N[a].prev, a, N[b].prev) != 0 || nodeTurn<Kernel>(N, a, N[b].prev, b) != 0))
+            return true;
+        // Two copies of one vertex, both reflex: a zero-length diagonal.
+        return N[a].p == N[b].p && nodeTurn<Kernel>(N, N[a].prev, a, N[a].next) == 1 &&
+               nodeTurn<Kernel>(N, N[b].prev, b, N[b].next) == 1;
+    }
+
+    // Whether the diagonal a - b leaves a into the polygon's interior.
+    template <typename Kernel, typename T>
+    static bool locallyInside(const std::pmr::vector<TriangulationNode<T>>& N, uint32_t a, uint32_t b) {
+        uint32_t prev = N[a].prev, next = N[a].next;
+        if (nodeTurn<Kernel>(N, prev, a, next) == 2)
+            return nodeTurn<Kernel>(N, a, b, next) != 2 && nodeTurn<Kernel>(N, a, prev, b) != 2;
+        return nodeTurn<Kernel>(N, a, b, prev) == 2 || nodeTurn<Kernel>(N, a, next, b) == 2;
+    }
+
+    // Crossing-number test of the midpoint of a - b against the ring.
+    template <typename T>
+    static bool middleInside(const std::pmr::vector<TriangulationNode<T>>& N, uint32_t a, uint32_t b) {
+        using W = Wide<T>;
+        W px = ((W)N[a].p.x + N[b].p.x) / 2, py = ((W)N[a].p.y + N[b].p.y) / 2;
+        bool inside = false;
+        uint32_t p = a;
+        do {
+            const Point<T>& u = N[p].p, & v = N[N[p].next].p;
+            if (((W)u.y > py) != ((W)v.y > py) && v.y != u.y && px < ((W)v.x - u.x) * (py - u.y) / ((W)v.y - u.y) + u.x)
+                inside = !inside;
+            p = N[p].next;
+        } while (p != a);
+        return inside;
+    }
+
+    // Splits the ring along a - b: a keeps a -> b, and copies of a and b
+    // form the other ring, whose node at b's copy is returned.
+    template <typename T>
+    static uint32_t splitRing(std::pmr::vector<TriangulationNode<T>>& N, uint32_t a, uint32_t b) {
+        uint32_t a2 = (uint32_t)N.size(), b2 = a2 + 1, an = N[a].next, bp = N[b].prev;
+        N.push_back(N[a]);
+        N.push_back(N[b]);
+        N[a].next = b;
+        N[b].prev = a;
+        N[a2].next = an;
+        N[an].prev = a2;
+        N[b2].next = a2;
+        N[a2].prev = b2;
+        N[bp].next = b2;
+        N[b2].prev = bp;
+        return b2;
+    }
+
+    // Status entry of the monotone sweep: the edge from ring vertex upper
+    // down to lower, its helper kept in scratch.helper[upper].
+    struct SweepEdge {
+        uint32_t upper, lower;
+    };
+
+    // Sweep order of the monotone partition: top to bottom, left to right
+    // on ties, so no edge is horizontal.
+    template <typename T>
+    static bool sweepAbove(const Point<T>* P, uint32_t a, uint32_t b) {
+        if (P[a].y != P[b].y) return P[a].y > P[b].y;
+        if (P[a].x != P[b].x) return P[a].x < P[b].x;
+        return a < b;
+    }
+
+    // Left-to-right order of the status edges at the sweep line: test the
+    // upper end of the later edge against the earlier one. A query point v
+    // is passed as the edge v -> v.
+    template <typename Kernel, typename T>
+    struct SweepEdgeLess {
+        const Point<T>* P;
+
+        bool operator()(const SweepEdge& a, const SweepEdge& b) const {
+            if (a.upper == b.upper && a.lower == b.lower) return false;
+            if (a.upper == b.upper || sweepAbove(P, b.upper, a.upper)) {
+                int o = orientation<Kernel>(P[b.upper], P[b.lower], P[a.upper]);
+                if (o == 0) o = orientation<Kernel>(P[b.upper], P[b.lower], P[a.lower]);
+                return o == 1;
+            }
+            int o = orientation<Kernel>(P[a.upper], P[a.lower], P[b.upper]);
+            if (o == 0) o = orientation<Kernel>(P[a.upper], P[a.lower], P[b.lower]);
+            return o == 2;
+        }
+    };
+
+    // Monotone partition and triangulation of the ring through start. Returns
+    // false if the sweep finds the polygon is not simple.
+    template <typename Kernel, typename T, typename Alloc>
+    static bool monotoneTriangulate(TriangulationScratch<T>& s, uint32_t start, std::vector<uint32_t, Alloc>& out,
+                                    uint32_t base) {
+        const auto& N = s.nodes;
+        s.ring.clear();
+        s.points.clear();
+        uint32_t p = start;
+        do {
+            s.ring.push_back(N[p].i);
+            s.points.push_back(N[p].p);
+            p = N[p].next;
+        } while (p != start);
+        uint32_t m = (uint32_t)s.ring.size();
+        const Point<T>* P = s.points.data();
+        auto prev = [m](uint32_t v) { return v ? v - 1 : m - 1; };
+        auto next = [m](uint32_t v) { return v + 1 < m ? v + 1 : 0; };
+        auto isMerge = [&](uint32_t v) {
+            return sweepAbove(P, prev(v), v) && sweepAbove(P, next(v), v) &&
+                   orientation<Kernel>(P[prev(v)], P[v], P[next(v)]) == 1;
+        };
+
+        s.order.resize(m);
+        for (uint32_t v = 0; v < m; ++v) s.order[v] = v;
+        std::sort(s.order.begin(), s.order.end(), [P](uint32_t a, uint32_t b) { return sweepAbove(P, a, b); });
+        s.helper.assign(m, 0);
+        s.diagonals.clear();
+        auto diagonal = [&](uint32_t u, uint32_t v) {
+            if (u == v || u == prev(v) || u == next(v)) return;
+            s.diagonals.push_back(u);
+            s.diagonals.push_back(v);
+        };
+
+        std::pmr::set<SweepEdge, SweepEdgeLess<Kernel, T>> status(SweepEdgeLess<Kernel, T>{P},
+                                                                  s.order.get_allocator().resource());
+        auto leftOf = [&](uint32_t v) {
+            auto it = status.lower_bound({v, v});
+            return it == status.begin() ? status.end() : std::prev(it);
+        };
+        for (uint32_t v : s.order) {
+            uint32_t a = prev(v), b = next(v);
+            bool prevBelow = sweepAbove(P, v, a), nextBelow = sweepAbove(P, v, b);
+            bool convex = orientation<Kernel>(P[a], P[v], P[b]) == 2;
+            if (!prevBelow && nextBelow) {
+                // Regular vertex with the interior to its right: hand the
+                // chain over from edge a -> v to v -> b.
+                auto it = status.find({a, v});
+                if (it == status.end()) return false;
+                if (isMerge(s.helper[a])) diagonal(v, s.helper[a]);
+                status.erase(it);
+                status.insert({v, b});
+                s.helper[v] = v;
+                continue;
+            }
+            if (!prevBelow && !nextBelow) {
+                // End or merge vertex: edge a -> v ends here.
+                auto it = status.find({a, v});
+                if (it == status.end()) return false;
+                if (isMerge(s.helper[a])) diagonal(v, s.helper[a]);
+                status.erase(it);
+                if (convex) continue;
+            }
+            if (!(prevBelow && nextBelow && convex)) {
+                // Split, merge, or regular with the interior to its left:
+                // connect to the edge on the left.
+                auto it = leftOf(v);
+                if (it == status.end()) return false;
+                uint32_t& h = s.helper[it->upper];
+                if (!(prevBelow && nextBelow) ? isMerge(h) : true) diagonal(v, h);
+                h = v;
+            }
+            if (prevBelow && nextBelow) {
+                // Start or split vertex: edge v -> b starts here.
+                status.insert({v, b});
+                s.helper[v] = v;
+            }
+        }
+        return monotonePieces<Kernel>(s, m, out, base);
+    }
+
+    // Walks the faces of the ring cut along scratch.diagonals and
+    // triangulates each, all of them y-monotone. Half-edge v < m is the ring
+    // edge v -> v + 1; half-edges m + 2k and m + 2k + 1 are diagonal k both
+    // ways.
+    template <typename Kernel, typename T, typename Alloc>
+    static bool monotonePieces(TriangulationScratch<T>& s, uint32_t m, std::vector<uint32_t, Alloc>& out, uint32_t base) {
+        const Point<T>* P = s.points.data();
+        const auto& D = s.diagonals;
+        uint32_t halfEdges = m + (uint32_t)D.size();
+        auto from = [&](uint32_t h) { return h < m ? h : D[h - m]; };
+
+        // Outgoing half-edges of each vertex, counter-clockwise from its ring
+        // edge; s.slot[h - m] is where diagonal half-edge h sits.
+        s.edgeStart.assign(m + 1, 1);
+        s.edgeStart[m] = 0;
+        for (uint32_t u : D) ++s.edgeStart[u];
+        for (uint32_t v = 0, sum = 0; v <= m; ++v) {
+            uint32_t c = s.edgeStart[v];
+            s.edgeStart[v] = sum;
+            sum += c;
+        }
+        s.edges.resize(halfEdges);
+        s.slot.resize(D.size());
+        for (uint32_t v = 0; v < m; ++v) s.edges[s.edgeStart[v]] = v;
+        s.stack.assign(s.edgeStart.begin(), s.edgeStart.end() - 1);
+        for (uint32_t h = m; h < halfEdges; ++h) s.edges[++s.stack[from(h)]] = h;
+        for (uint32_t v = 0; v < m; ++v) {
+            uint32_t lo = s.edgeStart[v] + 1, hi = s.edgeStart[v + 1];
+            if (hi - lo > 1) {
+                Point<T> o = P[v], r = P[v + 1 < m ? v + 1 : 0];
+                auto half = [&](uint32_t h) {
+                    int t = orientation<Kernel>(o, r, P[D[(h - m) ^ 1]]);
+                    return t == 2 ? 0 : (t == 0 ? 1 : 2);
+                };
+                std::sort(s.edges.begin() + lo, s.edges.begin() + hi, [&](uint32_t g, uint32_t h) {
+                    int hg = half(g), hh = half(h);
+                    if (hg != hh) return hg < hh;
+                    return orientation<Kernel>(o, P[D[(g - m) ^ 1]], P[D[(h - m) ^ 1]]) == 2;
+                });
+            }
+            for (uint32_t k = lo; k < hi; ++k) s.slot[s.edges[k] - m] = k;
+        }
+        // The face continues from h = u -> v with the outgoing edge just
+        // clockwise of v -> u.
+        auto successor = [&](uint32_t h) {
+            if (h < m) {
+                uint32_t v = h + 1 < m ? h + 1 : 0;
+                return s.edges[s.edgeStart[v + 1] - 1];
+            }
+            return s.edges[s.slot[(h - m) ^ 1] - 1];
+        };
+
+        s.visited.assign(halfEdges, 0);
+        size_t triangles = 0;
+        for (uint32_t first = 0; first < halfEdges; ++first) {
+            if (s.visited[first]) continue;
+            s.piece.clear();
+            uint32_t h = first;
+            do {
+                if (s.visited[h] || s.piece.size() == m) return false;
+                s.visited[h] = 1;
+                s.piece.push_back(from(h));
+                h = successor(h);
+            } while (h != first);
+            if (s.piece.size() < 3) return false;
+            triangles += monotonePiece<Kernel>(s, out, base);
+        }
+        return triangles == m - 2;
+    }
+
+    // Stack triangulation of the y-monotone piece scratch.piece, counter-
+    // clockwise ring vertices: merge its two chains into sweep order, then
+    // cut every vertex that turns the right way off the stack of pending
+    // ones. Returns the number of triangles appended.
+    template <typename Kernel, typename T, typename Alloc>
+    static size_t monotonePiece(TriangulationScratch<T>& s, std::vector<uint32_t, Alloc>& out, uint32_t base) {
+        const Point<T>* P = s.points.data();
+        const auto& piece = s.piece;
+        uint32_t k = (uint32_t)piece.size(), top = 0, bottom = 0;
+        for (uint32_t j = 1; j < k; ++j) {
+            if (sweepAbove(P, piece[j], piece[top])) top = j;
+            if (sweepAbove(P, piece[bottom], piece[j])) bottom = j;
+        }
+        // Going forward from the top descends the left chain.
+        uint32_t leftLength = (bottom + k - top) % k;
+        auto onLeft = [&](uint32_t j) { return (j + k - top) % k <= leftLength; };
+        auto& order = s.order;
+        order.clear();
+        order.push_back(top);
+        for (uint32_t l = (top + 1) % k, r = (top + k - 1) % k; l != bottom || r != bottom;) {
+            if (l != bottom && (r == bottom || sweepAbove(P, piece[l], piece[r]))) {
+                order.push_back(l);
+                l = (l + 1) % k;
+            } else {
+                order.push_back(r);
+                r = (r + k - 1) % k;
+            }
+        }
+        order.push_back(bottom);
+
+        size_t triangles = 0;
+        auto emit = [&](uint32_t a, uint32_t b, uint32_t c) {
+            a = piece[a], b = piece[b], c = piece[c];
+            if (orientation<Kernel>(P[a], P[b], P[c]) == 1) std::swap(b, c);
+            emitTriangle(out, base, s.ring[a], s.ring[b], s.ring[c]);
+            ++triangles;
+        };
+        auto& stack = s.stack;
+        stack.assign({order[0], order[1]});
+        for (uint32_t j = 2; j + 1 < k; ++j) {
+            uint32_t u = order[j];
+            if (onLeft(u) != onLeft(stack.back())) {
+                for (size_t t = stack.size() - 1; t > 0; --t) emit(u, stack[t], stack[t - 1]);
+                stack.assign({order[j - 1], u});
+            } else {
+                uint32_t last = stack.back();
+                stack.pop_back();
+                while (!stack.empty()) {
+                    uint32_t w = stack.back();
+                    const Point<T>& pu = P[piece[u]], & pl = P[piece[last]], & pw = P[piece[w]];
+                    bool inside = onLeft(u) ? orientation<Kernel>(pw, pl, pu) == 2 : orientation<Kernel>(pu, pl, pw) == 2;
+                    if (!inside) break;
+                    emit(u, last, w);
+                    last = w;
+                    stack.pop_back();
+                }
+                stack.push_back(last);
+                stack.push_back(u);
+            }
+        }
+        for (size_t t = stack.size() - 1; t > 0; --t) emit(order[k - 1], stack[t], stack[t - 1]);
+        return triangles;
+    }
+
+    // Rotating calipers over a counter-clockwise hull.
+    template <typename T, typename Alloc>
+    static long double hullDiameter(const std::vector<Point<T>, Alloc>& hull) {
+        if (hull.size() == 2)
+            return std::sqrt(distSq(hull[0], hull[1]));
+        if (hull.size() < 2)
+            return 0.0;
+
+        int n = hull.size();
+        long double max_dist_sq = 0.0;
+        int j = 1;
+
+        for (int i = 0; i < n; ++i) {
+            while (true) {
+                Point<T> p1 = hull[i];
+                Point<T> p2 = hull[(i + 1) % n];
+                Point<T> q1 = hull[j];
+                Point<T> q2 = hull[(j + 1) % n];
+
+                // Edge vectors are widened before subtracting: a difference of
+                // two T coordinates need not fit in T.
+                Point<long double> vec_p = {(long double)p2.x - p1.x, (long double)p2.y - p1.y};
+                Point<long double> vec_q = {(long double)q2.x - q1.x, (long double)q2.y - q1.y};
+
+                long double cross_prod = vec_p.x * vec_q.y - vec_p.y * vec_q.x; // Cross Product
+
+                if (cross_prod > 0)
+                    j = (j + 1) % n;
+                else
+                    break;
+            }
+
+            max_dist_sq = std::max(max_dist_sq, distSq(hull[i], hull[j]));
+            max_dist_sq = std::max(max_dist_sq, distSq(hull[(i + 1) % n], hull[j]));
+        }
+
+        return std::sqrt(max_dist_sq);
+    }
+
+    // Convex polygon through the eight directional extremes, with its edges
+    // also kept as line coefficients for the floating-point EpsilonKernel test.
+    template <typename T>
+    struct Octagon {
+        size_t n = 0;
+        Point<T> v[9]; // v[n] repeats v[0]
+        Wide<T> bx[8], by[8], dx[8], dy[8];
+
+        // Counter-clockwise of every edge under the hull's own kernel, so a
+        // culled point is one the chain would have discarded anyway.
+        template <typename Kernel>
+        bool strictlyInside(Point<T> r) const {
+            if constexpr (std::is_same<Kernel, EpsilonKernel>::value && std::is_floating_point<T>::value) {
+                for (size_t i = 0; i < n; ++i)
+                    if (dy[i] * ((Wide<T>)r.x - bx[i]) - dx[i] * ((Wide<T>)r.y - by[i]) > -EPS) return false;
+            } else {
+                for (size_t i = 0; i < n; ++i)
+                    if (orientation<Kernel>(v[i], v[i + 1], r) != 2) return false;
+            }
+            return true;
+        }
+    };
+
+    template <typename Kernel, typename T>
+    static Octagon<T> octagon(const Point<T>* pts, size_t count) {
+        Octagon<T> oct;
+        if (count < 3) return oct;
+
+        // minY, max(x - y), maxX, max(x + y), maxY, min(x - y), minX, min(x + y)
+        size_t ext[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (size_t i = 1; i < count; ++i) {
+            Wide<T> x = pts[i].x, y = pts[i].y;
+            if (y < pts[ext[0]].y) ext[0] = i;
+            if (x - y > (Wide<T>)pts[ext[1]].x - pts[ext[1]].y) ext[1] = i;
+            if (x > pts[ext[2]].x) ext[2] = i;
+            if (x + y > (Wide<T>)pts[ext[3]].x + pts[ext[3]].y) ext[3] = i;
+            if (y > pts[ext[4]].y) ext[4] = i;
+            if (x - y < (Wide<T>)pts[ext[5]].x - pts[ext[5]].y) ext[5] = i;
+            if (x < pts[ext[6]].x) ext[6] = i;
+            if (x + y < (Wide<T>)pts[ext[7]].x + pts[ext[7]].y) ext[7] = i;
+        }
+
+        // Ties can repeat or align extremes; hulling the eight points yields a
+        // proper convex polygon (or fewer than three vertices, meaning no cull).
+        Point<T> corners[8];
+        for (size_t k = 0; k < 8; ++k) corners[k] = pts[ext[k]];
+        std::sort(corners, corners + 8);
+        // The chain over 8 points never holds more than 16, so it runs on the
+        // stack; the prefilter allocates nothing.
+        alignas(Point<T>) unsigned char storage[16 * sizeof(Point<T>)];
+        std::pmr::monotonic_buffer_resource arena(storage, sizeof(storage), std::pmr::null_memory_resource());
+        std::pmr::vector<Point<T>> poly(&arena);
+        poly.reserve(16);
+        monotoneChain<Kernel>(corners, 8, poly);
+        if (poly.size() < 3) return oct;
+
+        oct.n = poly.size();
+        std::copy(poly.begin(), poly.end(), oct.v);
+        oct.v[oct.n] = poly[0];
+        for (size_t i = 0; i < oct.n; ++i) {
+            const Point<T>& a = oct.v[i];
+            const Point<T>& b = oct.v[i + 1];
+            oct.bx[i] = b.x;
+            oct.by[i] = b.y;
+            oct.dx[i] = (Wide<T>)b.x - a.x;
+            oct.dy[i] = (Wide<T>)b.y - a.y;
+        }
+        return oct;
+    }
+
+    // Moves the points that survive the octagon test to the front of
+    // pts[0, count) and returns how many there are.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static size_t cullInterior(Point<T>* pts, size_t count) {
+        Octagon<T> oct = octagon<Kernel>(pts, count);
+        if (oct.n < 3) return count;
+        return std::partition(pts, pts + count, [&](const Point<T>& p) { return !oct.template strictlyInside<Kernel>(p); }) - pts;
+    }
+
+    // Sweep-line state for the segment intersection queries. The sweep moves
+    // left to right over events ordered by (x, y); the status tree orders the
+    // active segments by their y at the current event, ties broken by slope
+    // (the order just right of the event) and then by index. Segments through
+    // the current event are pinned to the event's y so that reinserting them
+    // in reversed order cannot disagree with rounding in their computed y.
+    template <typename T>
+    class SegmentSweep {
+    public:
+        enum Mode { Report, Count, Any };
+
+        SegmentSweep(const Segment<T>* segs, size_t n, Mode mode, std::vector<std::pair<size_t, size_t>>* out)
+            : segs(segs), n(n), mode(mode), out(out), status(Order{this}) {
+            lo.resize(n); hi.resize(n); stamp.assign(n, 0); where.resize(n); active.assign(n, 0);
+            for (size_t i = 0; i < n; ++i) {
+                lo[i] = segs[i].a;
+                hi[i] = segs[i].b;
+                if (hi[i] < lo[i]) std::swap(lo[i], hi[i]);
+                Event& start = events[key(lo[i])];
+                start.starts.push_back(i);
+                start.endpoint = true;
+                events[key(hi[i])].endpoint = true;
+            }
+        }
+
+        // Number of intersecting pairs (0 or 1 in Any mode).
+        size_t run() {
+            while (!events.empty()) {
+                auto ev = events.begin();
+                here = ev->first;
+                std::vector<size_t> starts = std::move(ev->second.starts);
+                events.erase(ev);
+                if (handle(starts)) break;
+            }
+            return found;
+        }
+
+    private:
+        struct Key {
+            long double x, y;
+            bool operator<(const Key& o) const { return x != o.x ? x < o.x : y < o.y; }
+            bool operator==(const Key& o) const { return x == o.x && y == o.y; }
+        };
+        struct Probe {
+            long double y;
+        };
+        struct Event {
+            std::vector<size_t> starts; // segments whose lower endpoint this is
+            bool endpoint = false;      // false for a computed crossing
+        };
+        struct Order {
+            const SegmentSweep* s;
+            using is_transparent = void;
+            bool operator()(size_t a, size_t b) const { return s->below(a, b); }
+            bool operator()(size_t a, Probe p) const { return s->yAt(a) < p.y; }
+            bool operator()(Probe p, size_t a) const { return p.y < s->yAt(a); }
+        };
+        using Status = std::set<size_t, Order>;
+
+        const Segment<T>* segs;
+        size_t n;
+        Mode mode;
+        std::vector<std::pair<size_t, size_t>>* out;
+        std::vector<Point<T>> lo, hi;
+        std::vector<size_t> stamp;
+        std::vector<typename Status::iterator> where;
+        std::vector<char> active;
+        std::map<Key, Event> events;
+        Status status;
+        Key here{0, 0};
+        size_t tick = 0, found = 0;
+        std::vector<size_t> group;
+        long double column = std::numeric_limits<long double>::quiet_NaN(); // x of the first event at (about) the current x
+        std::vector<std::pair<size_t, size_t>> recent; // pairs reported within that column
+
+        static Key key(Point<T> p) { return {(long double)p.x, (long double)p.y}; }
+
+        long double tol(Key k) const { return 1e-12L * (1 + std::abs(k.x) + std::abs(k.y)); }
+
+        long double yAt(size_t s) const {
+            if (stamp[s] == tick) return here.y;
+            if (lo[s].x == hi[s].x) return std::min<long double>(std::max<long double>(here.y, lo[s].y), hi[s].y);
+            return lo[s].y + (here.x - lo[s].x) * ((long double)hi[s].y - lo[s].y) / ((long double)hi[s].x - lo[s].x);
+        }
+
+        bool below(size_t a, size_t b) const {
+            long double ya = yAt(a), yb = yAt(b);
+            if (ya != yb) return ya < yb;
+            long double dxa = (long double)hi[a].x - lo[a].x, dya = (long double)hi[a].y - lo[a].y;
+            long double dxb = (long double)hi[b].x - lo[b].x, dyb = (long double)hi[b].y - lo[b].y;
+            long double lhs = dya * dxb, rhs = dyb * dxa; // slope a < slope b; vertical is steepest
+            if (dxa == 0 && dxb == 0) return a < b;
+            if (dxa == 0) return false;
+            if (dxb == 0) return true;
+            if (lhs != rhs) return lhs < rhs;
+            return a < b;
+        }
+
+        bool intersects(size_t a, size_t b) const { return doIntersect(lo[a], hi[a], lo[b], hi[b]); }
+
+        // Returns true when an Any-mode sweep can stop.
+        bool record(size_t a, size_t b) {
+            if (a > b) std::swap(a, b);
+            if (!intersects(a, b)) return false;
+            // Collinear overlaps meet at several events; keep the first common point.
+            if (orientation(lo[a], hi[a], lo[b]) == 0 && orientation(lo[a], hi[a], hi[b]) == 0 &&
+                !(here == key(std::max(lo[a], lo[b]))))
+                return false;
+            if (std::find(recent.begin(), recent.end(), std::make_pair(a, b)) != recent.end()) return false;
+            recent.emplace_back(a, b);
+            ++found;
+            if (out) out->emplace_back(a, b);
+            return mode == Any;
+        }
+
+        // Neighbours in the status: in Any mode any contact ends the sweep,
+        // otherwise a proper crossing right of the sweep becomes an event.
+        bool check(size_t a, size_t b) {
+            if (!intersects(a, b)) return false;
+            if (mode == Any) return record(a, b);
+            long double rx = (long double)hi[a].x - lo[a].x, ry = (long double)hi[a].y - lo[a].y;
+            long double sx = (long double)hi[b].x - lo[b].x, sy = (long double)hi[b].y - lo[b].y;
+            long double denom = rx * sy - ry * sx;
+            if (denom == 0) return false; // collinear overlap starts at an endpoint event
+            long double t = (((long double)lo[b].x - lo[a].x) * sy - ((long double)lo[b].y - lo[a].y) * sx) / denom;
+            Key p{lo[a].x + t * rx, lo[a].y + t * ry};
+            // Clamped to both segments' boxes: a crossing with a vertical
+            // segment then has its exact x and cannot sort after its end.
+            p.x = std::min(std::max(p.x, (long double)std::max(lo[a].x, lo[b].x)), (long double)std::min(hi[a].x, hi[b].x));
+            p.y = std::min(std::max(p.y, (long double)std::max(std::min(lo[a].y, hi[a].y), std::min(lo[b].y, hi[b].y))),
+                           (long double)std::min(std::max(lo[a].y, hi[a].y), std::max(lo[b].y, hi[b].y)));
+            if (!(here < p) || near(p, here)) return false;
+            if (near(p, key(lo[a])) || near(p, key(hi[a])) || near(p, key(lo[b])) || near(p, key(hi[b])))
+                return false; // they meet at an endpoint, which is already an event
+
+            // Rounding can place one crossing a hair away from an event that
+            // already covers it; those are merged rather than queued again.
+            // A pair reported in this column has been through its crossing.
+            // Otherwise the crossing needs an event even if it rounds close
+            // to one already handled, which happens when a vertical segment
+            // starts just after that event. A merged crossing keeps the
+            // earlier of the two points, or one computed against a vertical
+            // segment could run after it ends.
+            if (std::find(recent.begin(), recent.end(), std::make_pair(std::min(a, b), std::max(a, b))) != recent.end())
+                return false;
+            long double slack = tol(p);
+            for (auto it = events.lower_bound(Key{p.x - slack, -std::numeric_limits<long double>::infinity()});
+                 it != events.end() && it->first.x <= p.x + slack; ++it) {
+                if (!near(it->first, p)) continue;
+                if (p < it->first && !it->second.endpoint) {
+                    auto node = events.extract(it);
+                    node.key() = p;
+                    events.insert(std::move(node));
+                }
+                return false;
+            }
+            events.emplace(p, Event());
+            return false;
+        }
+
+        bool near(Key a, Key b) const {
+            long double t = tol(a);
+            return std::abs(a.x - b.x) <= t && std::abs(a.y - b.y) <= t;
+        }
+
+        bool handle(const std::vector<size_t>& starts) {
+            ++tick;
+            if (!(std::abs(here.x - column) <= tol(here))) {
+                column = here.x;
+                recent.clear();
+            }
+
+            // Everything through the event: the segments starting here plus
+            // active ones whose y at the event matches (ending or passing).
+            group = starts;
+            long double t = tol(here);
+            for (auto it = status.lower_bound(Probe{here.y - t}); it != status.end() && yAt(*it) <= here.y + t; ++it)
+                if (yAt(*it) >= here.y - t) group.push_back(*it);
+
+            for (size_t i = 0; i < group.size(); ++i)
+                for (size_t j = i + 1; j < group.size(); ++j)
+                    if (record(group[i], group[j])) return true;
+
+            for (size_t s : group) {
+                if (active[s]) {
+                    status.erase(where[s]);
+                    active[s] = 0;
+                }
+            }
+            for (size_t s : group) stamp[s] = tick;
+
+            size_t low = n, high = n;
+            for (size_t s : group) {
+                if (!(here < key(hi[s]))) continue; // ends here
+                where[s] = status.insert(s).first;
+                active[s] = 1;
+                if (low == n || below(s, low)) low = s;
+                if (high == n || below(high, s)) high = s;
+            }
+
+            if (low == n) {
+                auto it = status.lower_bound(Probe{here.y});
+                if (it != status.end() && it != status.begin())
+                    return check(*std::prev(it), *it);
+                return false;
+            }
+            if (where[low] != status.begin() && check(*std::prev(where[low]), low)) return true;
+            auto next = std::next(where[high]);
+            return next != status.end() && check(high, *next);
+        }
+    };
+
+    // Andrew's monotone chain over points sorted by operator<, writing the
+    // counter-clockwise hull (collinear points dropped) into hull.
+    template <typename Kernel = EpsilonKernel, typename T, typename Hull>
+    static void monotoneChain(const Point<T>* points, size_t n, Hull& hull) {
+        hull.clear();
+        if (n <= 2) {
+            hull.assign(points, points + n);
+            return;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            while (hull.size() >= 2 &&
+                   orientation<Kernel>(hull[hull.size() - 2], hull.back(), points[i]) != 2) {
+                COMP_GEOM_2D_COUNT(hullPops, 1);
+                hull.pop_back();
+            }
+            hull.push_back(points[i]);
+        }
+
+        size_t t = hull.size() + 1;
+        for (size_t i = n - 1; i-- > 0;) {
+            while (hull.size() >= t &&
+                   orientation<Kernel>(hull[hull.size() - 2], hull.back(), points[i]) != 2) {
+                COMP_GEOM_2D_COUNT(hullPops, 1);
+                hull.pop_back();
+            }
+            hull.push_back(points[i]);
+        }
+
+        hull.pop_back();
+    }
+
+    // isInsideConvex for hulls of fewer than three vertices: a point or a segment.
+    template <typename Kernel = EpsilonKernel, typename T>
+    static bool convexDegenerate(const std::vector<Point<T>>& hull, Point<T> p) {
+        if (hull.empty()) return false;
+        if (hull.size() == 1) return hull[0] == p;
+        return orientation<Kernel>(hull[0], p, hull[1]) == 0 && onSegment(hull[0], p, hull[1]);
+    }
+
+    // One edge a -> b of the crossing-number test: 2 if p lies on the edge,
+    // 1 if the edge crosses the ray from p towards +x, otherwise 0. Works on
+    // coordinate differences only, so no ray endpoint at numeric_limits<T>::max().
+    template <typename Kernel = EpsilonKernel, typename T>
+    static int rayCrossing(Point<T> a, Point<T> b, Point<T> p) {
+        int o = orientation<Kernel>(a, b, p);
+        if (o == 0 && onSegment(a, p, b)) return 2;
+        bool straddles = (b.y > p.y) != (a.y > p.y);
+        return (straddles && ((o == 2) == (b.y > a.y))) ? 1 : 0;
+    }
+
+    // Exact orientation for integral coordinates: differences are taken one
+    // size up so they cannot overflow, products in __int128.
+    template <typename T>
+    static int integerOrientation(Point<T> p, Point<T> q, Point<T> r) {
+#if defined(__SIZEOF_INT128__)
+        if constexpr (sizeof(T) <= 2) {
+            int64_t val = ((int64_t)q.y - p.y) * ((int64_t)r.x - q.x) - ((int64_t)q.x - p.x) * ((int64_t)r.y - q.y);
+            return val == 0 ? 0 : (val > 0 ? 1 : 2);
+        } else if constexpr (sizeof(T) <= 4) {
+            __int128 val = (__int128)((int64_t)q.y - p.y) * ((int64_t)r.x - q.x) -
+                           (__int128)((int64_t)q.x - p.x) * ((int64_t)r.y - q.y);
+            return val == 0 ? 0 : (val > 0 ? 1 : 2);
+        } else {
+            int s = productDifferenceSign((__int128)q.y - p.y, (__int128)r.x - q.x, (__int128)q.x - p.x, (__int128)r.y - q.y);
+            return s == 0 ? 0 : (s > 0 ? 1 : 2);
+        }
+#else
+        long double val = ((long double)q.y - p.y) * ((long double)r.x - q.x) - ((long double)q.x - p.x) * ((long double)r.y - q.y);
+        return val == 0 ? 0 : (val > 0 ? 1 : 2);
+#endif
+    }
+
+#if defined(__SIZEOF_INT128__)
+    // Sign of a * b - c * d for |a|, |b|, |c|, |d| < 2^64; the magnitudes of the
+    // products fit an unsigned __int128 even where the signed product would not.
+    static int productDifferenceSign(__int128 a, __int128 b, __int128 c, __int128 d) {
+        auto sign = [](__int128 v) { return (v > 0) - (v < 0); };
+        auto mag = [](__int128 v) { return (unsigned __int128)(v < 0 ? -v : v); };
+        int s1 = sign(a) * sign(b), s2 = sign(c) * sign(d);
+        if (s1 != s2) return s1 > s2 ? 1 : -1;
+        if (s1 == 0) return 0;
+        unsigned __int128 m1 = mag(a) * mag(b), m2 = mag(c) * mag(d);
+        if (m1 == m2) return 0;
+        return (m1 > m2) == (s1 > 0) ? 1 : -1;
+    }
+#endif
+
+    // Shewchuk's orient2d: positive if a, b, c turn counter-clockwise. The
+    // double evaluation is returned when its error bound proves the sign;
+    // otherwise the determinant is recomputed exactly.
+    static double orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+        double detleft = (ax - cx) * (by - cy);
+        double detright = (ay - cy) * (bx - cx);
+        double det = detleft - detright;
+        double detsum;
+        if (detleft > 0) {
+            if (detright <= 0) return det;
+            detsum = detleft + detright;
+        } else if (detleft < 0) {
+            if (detright >= 0) return det;
+            detsum = -detleft - detright;
+        } else {
+            return det;
+        }
+        constexpr double eps = std::numeric_limits<double>::epsilon() / 2;
+        constexpr double errBound = (3.0 + 16.0 * eps) * eps;
+        if (det >= errBound * detsum || -det >= errBound * detsum) return det;
+        return orient2dExact(ax, ay, bx, by, cx, cy);
+    }
+
+    // The in-circle determinant; permanent, when given, receives the sum of
+    // its terms' magnitudes, the scale its rounding error grows with.
+    template <typename W, typename T>
+    static W inCircleDet(Point<T> a, Point<T> b, Point<T> c, Point<T> d, W* permanent = nullptr) {
+        W adx = (W)a.x - d.x, ady = (W)a.y - d.y;
+        W bdx = (W)b.x - d.x, bdy = (W)b.y - d.y;
+        W cdx = (W)c.x - d.x, cdy = (W)c.y - d.y;
+        W alift = adx * adx + ady * ady, blift = bdx * bdx + bdy * bdy, clift = cdx * cdx + cdy * cdy;
+        if (permanent)
+            *permanent = alift * (std::abs(bdx * cdy) + std::abs(cdx * bdy)) + blift * (std::abs(cdx * ady) + std::abs(adx * cdy)) +
+                         clift * (std::abs(adx * bdy) + std::abs(bdx * ady));
+        return alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) + clift * (adx * bdy - bdx * ady);
+    }
+
+    // Exact in-circle sign. Each coordinate difference is computed as an
+    // exact sum of two doubles, the larger one the difference rounded once
+    // (64-bit integers are split at bit 32 for this), so Shewchuk's filtered
+    // double evaluation applies to every coordinate type. When its error bound
+    // cannot decide, 64-bit integers whose differences stay below 2^30 are
+    // evaluated in __int128, and everything else by expansion arithmetic on
+    // the stack, whose lengths the two-double differences bound.
+    template <typename T>
+    static int exactInCircle(Point<T> a, Point<T> b, Point<T> c, Point<T> d) {
+        constexpr bool fitsDouble = std::is_floating_point<T>::value || sizeof(T) <= 4;
+        auto diff = [](T u, T v, double* e) {
+            double hi, lo;
+            if constexpr (fitsDouble) {
+                twoDiff((double)u, (double)v, hi, lo);
+            } else {
+                // The high parts are multiples of 2^32 and the low parts below
+                // 2^32, so both differences are exact in a double.
+                int64_t ul = (int64_t)u & 0xFFFFFFFF, vl = (int64_t)v & 0xFFFFFFFF;
+                twoSum((double)((int64_t)u - ul) - (double)((int64_t)v - vl), (double)(ul - vl), hi, lo);
+            }
+            e[0] = lo;
+            e[1] = hi;
+        };
+        double adx[2], ady[2], bdx[2], bdy[2], cdx[2], cdy[2];
+        diff(a.x, d.x, adx);
+        diff(a.y, d.y, ady);
+        diff(b.x, d.x, bdx);
+        diff(b.y, d.y, bdy);
+        diff(c.x, d.x, cdx);
+        diff(c.y, d.y, cdy);
+
+        {
+            double bdxcdy = bdx[1] * cdy[1], cdxbdy = cdx[1] * bdy[1], cdxady = cdx[1] * ady[1];
+            double adxcdy = adx[1] * cdy[1], adxbdy = adx[1] * bdy[1], bdxady = bdx[1] * ady[1];
+            double alift = adx[1] * adx[1] + ady[1] * ady[1], blift = bdx[1] * bdx[1] + bdy[1] * bdy[1];
+            double clift = cdx[1] * cdx[1] + cdy[1] * cdy[1];
+            double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+            double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift + (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                               (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+            constexpr double eps = std::numeric_limits<double>::epsilon() / 2;
+            constexpr double errBound = (10.0 + 96.0 * eps) * eps;
+            if (det > errBound * permanent) return 1;
+            if (-det > errBound * permanent) return -1;
+        }
+#if defined(__SIZEOF_INT128__)
+        if constexpr (!fitsDouble) {
+            // Differences below 2^30 keep the degree-4 determinant below 2^124.
+            __int128 dx[3] = {(__int128)a.x - d.x, (__int128)b.x - d.x, (__int128)c.x - d.x};
+            __int128 dy[3] = {(__int128)a.y - d.y, (__int128)b.y - d.y, (__int128)c.y - d.y};
+            constexpr __int128 Limit = (__int128)1 << 30;
+            bool small = true;
+            for (int i = 0; i < 3; ++i) small = small && dx[i] < Limit && -dx[i] < Limit && dy[i] < Limit && -dy[i] < Limit;
+            if (small) {
+                __int128 det = (dx[0] * dx[0] + dy[0] * dy[0]) * (dx[1] * dy[2] - dx[2] * dy[1]) +
+                               (dx[1] * dx[1] + dy[1] * dy[1]) * (dx[2] * dy[0] - dx[0] * dy[2]) +
+                               (dx[2] * dx[2] + dy[2] * dy[2]) * (dx[0] * dy[1] - dx[1] * dy[0]);
+                return det == 0 ? 0 : (det > 0 ? 1 : -1);
+            }
+        }
+#endif
+
+        // Lengths: products of differences 8, cross and lift terms 16, their
+        // product 2 * 16 * 16, the determinant three of those.
+        double det[1536], term[512], lift[16], cross[16], left[8], right[8];
+        int m = 0;
+        auto addTerm = [&](const double* px, const double* py, const double* p, const double* q, const double* r,
+                           const double* u) {
+            int l = expansionSum(left, expansionProduct(px, 2, px, 2, left), right, expansionProduct(py, 2, py, 2, right), lift);
+            int k = expansionProduct(r, 2, u, 2, right);
+            for (int i = 0; i < k; ++i) right[i] = -right[i];
+            k = expansionSum(left, expansionProduct(p, 2, q, 2, left), right, k, cross);
+            k = expansionProduct(lift, l, cross, k, term);
+            for (int i = 0; i < k; ++i) m = growExpansion(det, m, term[i]);
+        };
+        addTerm(adx, ady, bdx, cdy, cdx, bdy);
+        addTerm(bdx, bdy, cdx, ady, adx, cdy);
+        addTerm(cdx, cdy, adx, bdy, bdx, ady);
+        double top = m ? det[m - 1] : 0;
+        return top == 0 ? 0 : (top > 0 ? 1 : -1);
+    }
+
+    // Fixed-size expansion arithmetic for the exact fallbacks. Inputs and
+    // results are nonoverlapping, smallest component first; each returns the
+    // result's length. h needs room for m + n components for a sum and
+    // 2 * m * n for a product.
+    static int expansionSum(const double* e, int m, const double* f, int n, double* h) {
+        std::copy(e, e + m, h);
+        for (int i = 0; i < n; ++i) m = growExpansion(h, m, f[i]);
+        return m;
+    }
+
+    static int expansionProduct(const double* e, int m, const double* f, int n, double* h) {
+        int k = 0;
+        for (int j = 0; j < n; ++j) {
+            for (int i = 0; i < m; ++i) {
+                double hi, lo;
+                twoProduct(e[i], f[j], hi, lo);
+                k = growExpansion(h, k, lo);
+                k = growExpansion(h, k, hi);
+            }
+        }
+        return k;
+    }
+
+    // Error-free transforms: a op b == x + y exactly.
+    static void twoSum(double a, double b, double& x, double& y) {
+        x = a + b;
+        double bv = x - a, av = x - bv;
+        y = (a - av) + (b - bv);
+    }
+    static void twoDiff(double a, double b, double& x, double& y) {
+        x = a - b;
+        double bv = a - x, av = x + bv;
+        y = (a - av) + (bv - b);
+    }
+    static void twoProduct(double a, double b, double& x, double& y) {
+        x = a * b;
+        y = std::fma(a, b, -x);
+    }
+
+    // Exact (ax - cx)(by - cy) - (ay - cy)(bx - cx): each difference is split
+    // into value + rounding error, the 16 partial products are summed into a
+    // nonoverlapping expansion, and its largest component carries the sign.
+    static double orient2dExact(double ax, double ay, double bx, double by, double cx, double cy) {
+        double acx[2], bcy[2], acy[2], bcx[2];
+        twoDiff(ax, cx, acx[1], acx[0]);
+        twoDiff(by, cy, bcy[1], bcy[0]);
+        twoDiff(ay, cy, acy[1], acy[0]);
+        twoDiff(bx, cx, bcx[1], bcx[0]);
+
+        double e[34];
+        int m = 0;
+        for (int i = 0; i < 2; ++i) {
+            for (int j = 0; j < 2; ++j) {
+                double hi, lo;
+                twoProduct(acx[i], bcy[j], hi, lo);
+                m = growExpansion(e, m, lo);
+                m = growExpansion(e, m, hi);
+                twoProduct(-acy[i], bcx[j], hi, lo);
+                m = growExpansion(e, m, lo);
+                m = growExpansion(e, m, hi);
+            }
+        }
+        return e[m - 1];
+    }
+
+    // Adds b to the nonoverlapping expansion e[0, m), smallest component first,
+    // dropping zero components. Returns the new length (at least 1).
+    static int growExpansion(double* e, int m, double b) {
+        double q = b;
+        int k = 0;
+        for (int i = 0; i < m; ++i) {
+            double sum, err;
+            twoSum(q, e[i], sum, err);
+            q = sum;
+            if (err != 0) e[k++] = err;
+        }
+        if (q != 0 || k == 0) e[k++] = q;
+        return k;
+    }
+
+    static SimdLevel detectSimdLevel() {
+#if defined(COMP_GEOM_2D_X86_SIMD)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("bmi2")) {
+            if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        }
+#elif defined(COMP_GEOM_2D_NEON)
+        return SimdLevel::NEON;
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    static_assert(sizeof(Point<double>) == 2 * sizeof(double), "batch kernels read Point<double> as interleaved x, y");
+
+    // Reference for the vector kernels and their tail loop: same arithmetic in
+    // plain double, starting at index `from`.
+    static void orientationBatchScalar(Point<double> p, Point<double> q, const Point<double>* r, size_t n, size_t from, int8_t* out) {
+        double dy = q.y - p.y, dx = q.x - p.x;
+        for (size_t i = from; i < n; ++i) {
+            double ax = r[i].x - q.x, ay = r[i].y - q.y;
+            double prod1 = dy * ax, prod2 = dx * ay;
+            double val = prod1 - prod2;
+            out[i] = (int8_t)((val >= EPS) | ((val <= -EPS) << 1));
+        }
+    }
+
+#if defined(COMP_GEOM_2D_X86_SIMD)
+    __attribute__((target("avx2,bmi2")))
+    static void orientationBatchAvx2(Point<double> p, Point<double> q, const Point<double>* r, size_t n, int8_t* out) {
+        const double* src = reinterpret_cast<const double*>(r);
+        const __m256d dy = _mm256_set1_pd(q.y - p.y), dx = _mm256_set1_pd(q.x - p.x);
+        const __m256d qx = _mm256_set1_pd(q.x), qy = _mm256_set1_pd(q.y);
+        const __m256d eps = _mm256_set1_pd(EPS), negEps = _mm256_set1_pd(-EPS);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d a = _mm256_loadu_pd(src + 2 * i);     // x0 y0 x1 y1
+            __m256d b = _mm256_loadu_pd(src + 2 * i + 4); // x2 y2 x3 y3
+            __m256d xs = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), 0xD8);
+            __m256d ys = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), 0xD8);
+            __m256d val = _mm256_sub_pd(_mm256_mul_pd(dy, _mm256_sub_pd(xs, qx)),
+                                        _mm256_mul_pd(dx, _mm256_sub_pd(ys, qy)));
+            unsigned pos = _mm256_movemask_pd(_mm256_cmp_pd(val, eps, _CMP_GE_OQ));
+            unsigned neg = _mm256_movemask_pd(_mm256_cmp_pd(val, negEps, _CMP_LE_OQ));
+            uint32_t codes = _pdep_u32(pos, 0x01010101u) | (_pdep_u32(neg, 0x01010101u) << 1);
+            std::memcpy(out + i, &codes, sizeof(codes));
+        }
+        orientationBatchScalar(p, q, r, n, i, out);
+    }
+
+    __attribute__((target("avx512f,bmi2")))
+    static void orientationBatchAvx512(Point<double> p, Point<double> q, const Point<double>* r, size_t n, int8_t* out) {
+        const double* src = reinterpret_cast<const double*>(r);
+        const __m512d dy = _mm512_set1_pd(q.y - p.y), dx = _mm512_set1_pd(q.x - p.x);
+        const __m512d qx = _mm512_set1_pd(q.x), qy = _mm512_set1_pd(q.y);
+        const __m512d eps = _mm512_set1_pd(EPS), negEps = _mm512_set1_pd(-EPS);
+        const __m512i evens = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i odds = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512d a = _mm512_loadu_pd(src + 2 * i);
+            __m512d b = _mm512_loadu_pd(src + 2 * i + 8);
+            __m512d xs = _mm512_permutex2var_pd(a, evens, b);
+            __m512d ys = _mm512_permutex2var_pd(a, odds, b);
+            __m512d val = _mm512_sub_pd(_mm512_mul_pd(dy, _mm512_sub_pd(xs, qx)),
+                                        _mm512_mul_pd(dx, _mm512_sub_pd(ys, qy)));
+            unsigned pos = _mm512_cmp_pd_mask(val, eps, _CMP_GE_OQ);
+            unsigned neg = _mm512_cmp_pd_mask(val, negEps, _CMP_LE_OQ);
+            uint64_t codes = _pdep_u64(pos, 0x0101010101010101ull) | (_pdep_u64(neg, 0x0101010101010101ull) << 1);
+            std::memcpy(out + i, &codes, sizeof(codes));
+        }
+        orientationBatchScalar(p, q, r, n, i, out);
+    }
+#elif defined(COMP_GEOM_2D_NEON)
+    static void orientationBatchNeon(Point<double> p, Point<double> q, const Point<double>* r, size_t n, int8_t* out) {
+        const double* src = reinterpret_cast<const double*>(r);
+        const float64x2_t dy = vdupq_n_f64(q.y - p.y), dx = vdupq_n_f64(q.x - p.x);
+        const float64x2_t qx = vdupq_n_f64(q.x), qy = vdupq_n_f64(q.y);
+        const float64x2_t eps = vdupq_n_f64(EPS), negEps = vdupq_n_f64(-EPS);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            float64x2x2_t xy = vld2q_f64(src + 2 * i); // val[0] = x0 x1, val[1] = y0 y1
+            float64x2_t val = vsubq_f64(vmulq_f64(dy, vsubq_f64(xy.val[0], qx)),
+                                        vmulq_f64(dx, vsubq_f64(xy.val[1], qy)));
+            uint64x2_t pos = vcgeq_f64(val, eps);
+            uint64x2_t neg = vcleq_f64(val, negEps);
+            out[i] = (int8_t)((vgetq_lane_u64(pos, 0) & 1) | ((vgetq_lane_u64(neg, 0) & 1) << 1));
+            out[i + 1] = (int8_t)((vgetq_lane_u64(pos, 1) & 1) | ((vgetq_lane_u64(neg, 1) & 1) << 1));
+        }
+        orientationBatchScalar(p, q, r, n, i, out);
+    }
+#endif
+
+    template <typename T>
+    static long double distSq(Point<T> p1, Point<T> p2) {
+        long double dx = (long double)p1.x - p2.x, dy = (long double)p1.y - p2.y;
+        return dx * dx + dy * dy;
+    }
+
+    // Below this many points the radix sort's fixed cost (a 2048-bucket
+    // histogram per digit) loses to std::sort.
+    static constexpr size_t RadixThreshold = 1 << 10;
+
+    template <typename T>
+    static constexpr bool radixSortable() {
+        return std::is_arithmetic<T>::value && (sizeof(T) == 4 || sizeof(T) == 8);
+    }
+
+    template <typename T>
+    using RadixKey = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+
+    // Unsigned key ordered like the coordinate: flip the sign bit of signed
+    // integers; for IEEE floats flip all bits of negatives and the sign bit of
+    // the rest. -0.0 is folded into +0.0, as operator< treats them as equal.
+    template <typename T>
+    static RadixKey<T> radixKey(T v) {
+        using K = RadixKey<T>;
+        constexpr K sign = K(1) << (sizeof(K) * 8 - 1);
+        if constexpr (std::is_floating_point<T>::value) {
+            v += T(0);
+            K u;
+            std::memcpy(&u, &v, sizeof(u));
+            return (u & sign) ? ~u : (u | sign);
+        } else if constexpr (std::is_signed<T>::value) {
+            return (K)v ^ sign;
+        } else {
+            return (K)v;
+        }
+    }
+
+    static constexpr unsigned RadixBits = 11;
+    static constexpr size_t RadixBuckets = size_t(1) << RadixBits;
+    static constexpr size_t RadixPasses = (64 + RadixBits - 1) / RadixBits;
+
+    // The 64-bit word the radix passes sort on. 4-byte coordinates pack the
+    // whole (major, minor) key into it; 8-byte ones use the major coordinate
+    // only and leave ties to radixSort's final fix-up.
+    template <bool ByY, typename T>
+    static uint64_t radixWord(const Point<T>& p) {
+        T major = ByY ? p.y : p.x, minor = ByY ? p.x : p.y;
+        if constexpr (sizeof(T) == 4) return (uint64_t)radixKey(major) << 32 | radixKey(minor);
+        else return radixKey(major);
+    }
+
+    template <bool ByY, typename T>
+    static bool pointLess(const Point<T>& a, const Point<T>& b) {
+        if constexpr (ByY) return a.y != b.y ? a.y < b.y : a.x < b.x;
+        else return a < b;
+    }
+
+    // Stable LSD radix sort of a[0, n) by the 64-bit word(a[i]), in 11-bit
+    // digits with tmp[0, n) as the second array. All digit histograms come
+    // from one counting pass, and a digit on which every key agrees costs no
+    // pass at all (high bits of small integers, exponent bits of clustered
+    // floats). Moving whole elements six times beats sixteen 8-bit passes or a
+    // key/index sort plus gather for the point sizes used here. The histograms
+    // come from mr, so a sort on pmr scratch stays inside its arena.
+    template <typename Elem, typename Word>
+    static void radixSortWords(Elem* a, size_t n, Elem* tmp, Word word,
+                               std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        if (n == 0) return;
+        std::pmr::vector<size_t> hist(RadixPasses * RadixBuckets, 0, mr);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t w = word(a[i]);
+            for (size_t d = 0; d < RadixPasses; ++d) ++hist[d * RadixBuckets + ((w >> (d * RadixBits)) & (RadixBuckets - 1))];
+        }
+
+        Elem* src = a;
+        Elem* dst = tmp;
+        for (size_t d = 0; d < RadixPasses; ++d) {
+            size_t* h = &hist[d * RadixBuckets];
+            unsigned shift = d * RadixBits;
+            if (h[(word(src[0]) >> shift) & (RadixBuckets - 1)] == n) continue;
+            for (size_t b = 0, sum = 0; b < RadixBuckets; ++b) {
+                size_t c = h[b];
+                h[b] = sum;
+                sum += c;
+            }
+            for (size_t i = 0; i < n; ++i) dst[h[(word(src[i]) >> shift) & (RadixBuckets - 1)]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != a) std::copy(src, src + n, a);
+    }
+
+    // radixSortWords with every pass split over `tasks` contiguous blocks on
+    // exec: each block counts its digits, the counts are prefix-summed per
+    // (digit, block) and every block scatters its share, which keeps the sort
+    // stable.
+    template <typename Elem, typename Word>
+    static void radixSortWordsParallel(Elem* a, size_t n, Elem* tmp, Word word, const Executor& exec, size_t tasks) {
+        if (n == 0) return;
+        std::vector<size_t> hist(tasks * RadixBuckets);
+        Elem* src = a;
+        Elem* dst = tmp;
+        for (size_t d = 0; d < RadixPasses; ++d) {
+            unsigned shift = d * RadixBits;
+            auto digit = [&](const Elem& e) { return (word(e) >> shift) & (RadixBuckets - 1); };
+            exec(tasks, [&](size_t t) {
+                size_t* h = &hist[t * RadixBuckets];
+                std::fill(h, h + RadixBuckets, 0);
+                for (size_t i = n * t / tasks, e = n * (t + 1) / tasks; i < e; ++i) ++h[digit(src[i])];
+            });
+            size_t first = digit(src[0]), total = 0;
+            for (size_t t = 0; t < tasks; ++t) total += hist[t * RadixBuckets + first];
+            if (total == n) continue;
+            for (size_t b = 0, sum = 0; b < RadixBuckets; ++b) {
+                for (size_t t = 0; t < tasks; ++t) {
+                    size_t c = hist[t * RadixBuckets + b];
+                    hist[t * RadixBuckets + b] = sum;
+                    sum += c;
+                }
+            }
+            exec(tasks, [&](size_t t) {
+                size_t* h = &hist[t * RadixBuckets];
+                for (size_t i = n * t / tasks, e = n * (t + 1) / tasks; i < e; ++i) dst[h[digit(src[i])]++] = src[i];
+            });
+            std::swap(src, dst);
+        }
+        if (src != a) std::copy(src, src + n, a);
+    }
+
+    // Radix sort of a[0, n) by the points get(a[i]) returns.
+    template <bool ByY, typename Elem, typename Get>
+    static void radixSort(Elem* a, size_t n, Elem* tmp, Get get,
+                          std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        using T = typename std::decay<decltype(get(*a).x)>::type;
+        radixSortWords(a, n, tmp, [&](const Elem& e) { return radixWord<ByY>(get(e)); }, mr);
+        if constexpr (sizeof(T) == 8) sortRadixTies<ByY>(a, n, get);
+    }
+
+    // Runs of equal major coordinate, left in input order by the major-only
+    // passes, sorted by the minor one.
+    template <bool ByY, typename Elem, typename Get>
+    static void sortRadixTies(Elem* a, size_t n, Get get) {
+        for (size_t i = 0; i < n;) {
+            uint64_t w = radixWord<ByY>(get(a[i]));
+            size_t j = i + 1;
+            while (j < n && radixWord<ByY>(get(a[j])) == w) ++j;
+            if (j - i > 1)
+                std::stable_sort(a + i, a + j, [&](const Elem& p, const Elem& q) { return pointLess<ByY>(get(p), get(q)); });
+            i = j;
+        }
+    }
+
+    // Sorts a[0, n) by get(a[i]): radix when it pays off, with tmp[0, n) as
+    // working space, std::sort otherwise (tmp is then unused).
+    template <bool ByY, typename Elem, typename Get>
+    static void sortElementsBy(Elem* a, size_t n, Elem* tmp, Get get,
+                               std::pmr::memory_resource* mr = std::pmr::get_default_resource()) {
+        using T = typename std::decay<decltype(get(*a).x)>::type;
+        if constexpr (radixSortable<T>()) {
+            if (n >= RadixThreshold) {
+                radixSort<ByY>(a, n, tmp, get, mr);
+                return;
+            }
+        }
+        std::sort(a, a + n, [&](const Elem& p, const Elem& q) { return pointLess<ByY>(get(p), get(q)); });
+    }
+
+    template <bool ByY, typename T, typename Buffer>
+    static void sortPointsBy(Point<T>* points, size_t n, Buffer& buffer) {
+        if (radixSortable<T>() && n >= RadixThreshold) buffer.resize(n);
+        sortElementsBy<ByY>(points, n, buffer.data(), [](const Point<T>& p) -> const Point<T>& { return p; },
+                            bufferResource(buffer));
+    }
+
+    template <typename V>
+    static std::pmr::memory_resource* bufferResource(const std::pmr::vector<V>& buffer) {
+        return buffer.get_allocator().resource();
+    }
+
+    template <typename V>
+    static std::pmr::memory_resource* bufferResource(const std::vector<V>&) {
+        return std::pmr::get_default_resource();
+    }
+
+    template <bool ByY, typename T>
+    static void sortPointsParallelBy(std::vector<Point<T>>& points, const Executor& exec, size_t tasks) {
+        constexpr size_t MinTask = 1 << 16;
+        size_t n = points.size();
+        tasks = std::min(tasks, n / MinTask);
+        if constexpr (radixSortable<T>()) {
+            if (tasks > 1) {
+                std::vector<Point<T>> buffer(n);
+                radixSortWordsParallel(points.data(), n, buffer.data(),
+                                       [](const Point<T>& p) { return radixWord<ByY>(p); }, exec, tasks);
+                if constexpr (sizeof(T) == 8)
+                    sortRadixTies<ByY>(points.data(), n, [](const Point<T>& p) -> const Point<T>& { return p; });
+                return;
+            }
+        }
+        std::vector<Point<T>> buffer;
+        sortPointsBy<ByY>(points.data(), n, buffer);
+    }
+
+    template <typename T>
+    static bool sortByY(const Point<T>& a, const Point<T>& b) {
+        return a.y < b.y;
+    }
+
+    template <typename T>
+    static void updateClosest(const IndexedPoint<T>& a, const IndexedPoint<T>& b, long double d, ClosestPairResult<T>& best) {
+        if (d < best.distance) {
+            best.distance = d;
+            best.first = a.p;
+            best.second = b.p;
+            best.firstIndex = a.index;
+            best.secondIndex = b.index;
+        }
+    }
+
+    // On entry pts[lo, hi) is sorted by x; on return it is sorted by y and best holds
+    // the squared distance of the closest pair seen so far.
+    template <typename T>
+    static void closestPairUtil(IndexedPoint<T>* pts, IndexedPoint<T>* buf, size_t lo, size_t hi, ClosestPairResult<T>& best) {
+        COMP_GEOM_2D_DEPTH();
+        size_t n = hi - lo;
+        if (n <= 3) {
+            for (size_t i = lo; i < hi; ++i)
+                for (size_t j = i + 1; j < hi; ++j)
+                    updateClosest(pts[i], pts[j], distSq(pts[i].p, pts[j].p), best);
+            for (size_t i = lo + 1; i < hi; ++i)
+                for (size_t j = i; j > lo && sortByY(pts[j].p, pts[j - 1].p); --j)
+                    std::swap(pts[j], pts[j - 1]);
+            return;
+        }
+
+        size_t mid = lo + n / 2;
+        T midX = pts[mid].p.x;
+
+        // Recurse
+        closestPairUtil(pts, buf, lo, mid, best);
+        closestPairUtil(pts, buf, mid, hi, best);
+        closestPairMerge(pts, buf, lo, mid, hi, midX, best);
+    }
+
+    // Combine step of closestPairUtil: pts[lo, mid) and pts[mid, hi) are each
+    // sorted by y and were split at x == midX; merges them and checks the strip.
+    template <typename T>
+    static void closestPairMerge(IndexedPoint<T>* pts, IndexedPoint<T>* buf, size_t lo, size_t mid, size_t hi, T midX,
+                                 ClosestPairResult<T>& best) {
+        std::merge(pts + lo, pts + mid, pts + mid, pts + hi, buf + lo,
+                   [](const IndexedPoint<T>& a, const IndexedPoint<T>& b) { return sortByY(a.p, b.p); });
+        std::copy(buf + lo, buf + hi, pts + lo);
+
+        // Build the "strip" of points close to the dividing line, reusing buf[lo, hi)
+        size_t stripEnd = lo;
+        for (size_t i = lo; i < hi; ++i) {
+            long double dx = (long double)pts[i].p.x - midX;
+            if (dx * dx < best.distance)
+                buf[stripEnd++] = pts[i];
+        }
+        COMP_GEOM_2D_COUNT(stripPoints, stripEnd - lo);
+
+        for (size_t i = lo; i < stripEnd; ++i) {
+            for (size_t j = i + 1; j < stripEnd; ++j) {
+                long double dy = (long double)buf[j].p.y - buf[i].p.y;
+                if (dy * dy >= best.distance) break;
+                COMP_GEOM_2D_COUNT(stripComparisons, 1);
+                updateClosest(buf[i], buf[j], distSq(buf[i].p, buf[j].p), best);
+            }
+        }
     }
 
 };
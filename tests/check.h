@@ -0,0 +1,28 @@
+// Shared by the programs in tests/: CHECK records a failure and keeps going,
+// and main() returns checkResult("name") so a run exits non-zero if any
+// check failed.
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                        \
+    do {                                                                                   \
+        if (!(cond)) {                                                                     \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++failures;                                                                    \
+        }                                                                                  \
+    } while (0)
+
+int checkResult(const char* name) {
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    else std::printf("%s: all checks passed\n", name);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace
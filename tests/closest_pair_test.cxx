@@ -0,0 +1,94 @@
+// Checks findClosestPairParallel against the serial closestPair with enough
+// points per task (MinTask is 2^14) that the nth_element split, the per-task
+// solves and every merge level actually run. Inputs include duplicates and
+// columns of equal x that straddle the splits, and the task count is not
+// always a power of two.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/closest_pair_test.cxx -lpthread -o closest_pair_test && ./closest_pair_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+long double distance(const Point<T>& a, const Point<T>& b) {
+    long double dx = (long double)a.x - b.x, dy = (long double)a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Runs the tasks in order on the calling thread, so failures reproduce.
+void serial(size_t count, const std::function<void(size_t)>& task) {
+    for (size_t i = 0; i < count; ++i) task(i);
+}
+
+template <typename T>
+void check(const std::vector<Point<T>>& pts) {
+    long double expected = G::closestPair(pts);
+    G::ClosestPairScratch<T> scratch;
+    for (size_t tasks : {2, 3, 4, 7, 8}) {
+        for (const G::Executor& exec : {G::Executor(serial), G::threadExecutor(4)}) {
+            G::ClosestPairResult<T> r = G::findClosestPairParallel(pts.data(), pts.size(), scratch, exec, tasks);
+            CHECK(r.distance == expected);
+            CHECK(r.firstIndex < pts.size() && r.secondIndex < pts.size() && r.firstIndex != r.secondIndex);
+            if (r.firstIndex < pts.size() && r.secondIndex < pts.size()) {
+                CHECK(pts[r.firstIndex].x == r.first.x && pts[r.firstIndex].y == r.first.y);
+                CHECK(pts[r.secondIndex].x == r.second.x && pts[r.secondIndex].y == r.second.y);
+                CHECK(distance(r.first, r.second) == expected);
+            }
+        }
+    }
+}
+
+template <typename T>
+std::vector<Point<T>> uniform(size_t n, double lo, double hi, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uni(lo, hi);
+    std::vector<Point<T>> pts(n);
+    for (auto& p : pts) p = Point<T>((T)uni(rng), (T)uni(rng));
+    return pts;
+}
+
+} // namespace
+
+int main() {
+    const size_t N = 150000; // over 8 * 2^14
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        check(uniform<double>(N, -1e6, 1e6, seed));
+        check(uniform<float>(N, -1e3, 1e3, seed));
+        check(uniform<int>(N, -1e8, 1e8, seed));
+        check(uniform<long long>(N, -1e15, 1e15, seed));
+    }
+
+    // The closest pair sits across a split: two vertical columns of points
+    // with the only close pair straddling the x of the first split.
+    std::vector<Point<int>> columns;
+    for (int i = 0; i < (int)N / 2; ++i) {
+        columns.push_back(Point<int>(0, 100 * i));
+        columns.push_back(Point<int>(1000, 100 * i + 50));
+    }
+    columns.push_back(Point<int>(499, 7));
+    columns.push_back(Point<int>(501, 7));
+    check(columns);
+
+    // Every x equal: nth_element splits a single column anywhere.
+    std::vector<Point<long long>> line;
+    for (long long i = 0; i < (long long)N; ++i) line.push_back(Point<long long>(5, (i * 7919) % (long long)N * 3));
+    check(line);
+
+    // Coarse lattice with duplicates: distance 0 somewhere.
+    std::mt19937 rng(9);
+    std::vector<Point<double>> lattice(N);
+    for (auto& p : lattice) p = Point<double>(rng() % 500, rng() % 500);
+    check(lattice);
+
+    return checkResult("closest pair");
+}
@@ -0,0 +1,127 @@
+// Checks Delaunay, euclideanMST and allNearestNeighbors under the default
+// kernel against brute force: every interior edge is locally Delaunay by the
+// exact in-circle sign, the tree weighs the same as Prim's, and every nearest
+// neighbour is at the brute-force distance. Unit-square doubles are the case
+// an absolute in-circle tolerance gets wrong; 64-bit integers beyond 2^30
+// take the exact expansion path.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/delaunay_test.cxx -lpthread -o delaunay_test && ./delaunay_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+long double distSq(const Point<T>& a, const Point<T>& b) {
+    long double dx = (long double)a.x - b.x, dy = (long double)a.y - b.y;
+    return dx * dx + dy * dy;
+}
+
+template <typename T>
+void check(const std::vector<Point<T>>& pts) {
+    size_t n = pts.size();
+    G::Delaunay<T> dt(pts);
+    CHECK(dt.triangleCount() > 0);
+
+    size_t violations = 0;
+    for (size_t e = 0; e < dt.triangles.size(); ++e) {
+        size_t twin = dt.halfedges[e];
+        if (twin == G::Delaunay<T>::None) continue;
+        const Point<T>& a = pts[dt.triangles[e]];
+        const Point<T>& b = pts[dt.triangles[G::Delaunay<T>::nextHalfedge(e)]];
+        const Point<T>& c = pts[dt.triangles[G::Delaunay<T>::prevHalfedge(e)]];
+        const Point<T>& d = pts[dt.triangles[G::Delaunay<T>::prevHalfedge(twin)]];
+        if (G::inCircle<G::ExactKernel>(a, b, c, d) > 0) ++violations;
+    }
+    CHECK(violations == 0);
+
+    // Prim's algorithm over the complete graph.
+    long double prim = 0;
+    std::vector<long double> best(n, std::numeric_limits<long double>::max());
+    std::vector<char> done(n, 0);
+    best[0] = 0;
+    for (size_t k = 0; k < n; ++k) {
+        size_t u = n;
+        for (size_t i = 0; i < n; ++i)
+            if (!done[i] && (u == n || best[i] < best[u])) u = i;
+        done[u] = 1;
+        prim += std::sqrt(best[u]);
+        for (size_t i = 0; i < n; ++i)
+            if (!done[i]) best[i] = std::min(best[i], distSq(pts[u], pts[i]));
+    }
+    auto tree = G::euclideanMST(pts, dt);
+    CHECK(tree.size() == n - 1);
+    long double weight = 0;
+    for (auto [u, v] : tree) weight += std::sqrt(distSq(pts[u], pts[v]));
+    CHECK(std::abs(weight - prim) <= 1e-9 * prim);
+
+    std::vector<size_t> nn = G::allNearestNeighbors(pts, dt);
+    size_t wrong = 0;
+    for (size_t i = 0; i < n; ++i) {
+        long double closest = std::numeric_limits<long double>::max();
+        for (size_t j = 0; j < n; ++j)
+            if (j != i) closest = std::min(closest, distSq(pts[i], pts[j]));
+        if (nn[i] == n || distSq(pts[i], pts[nn[i]]) != closest) ++wrong;
+    }
+    CHECK(wrong == 0);
+}
+
+template <typename T>
+std::vector<Point<T>> uniform(size_t n, double lo, double hi, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uni(lo, hi);
+    std::vector<Point<T>> pts(n);
+    for (auto& p : pts) p = Point<T>((T)uni(rng), (T)uni(rng));
+    return pts;
+}
+
+// Corners of a square are cocircular; moving the fourth one a unit inward or
+// outward decides the sign. Differences of 2^40 force the exact fallbacks.
+template <typename T>
+void checkInCircle(T origin) {
+    const T S = (T)(1LL << 40);
+    Point<T> a(origin, origin), b(origin + S, origin), c(origin + S, origin + S);
+    CHECK(G::inCircle(a, b, c, Point<T>(origin, origin + S)) == 0);
+    CHECK(G::inCircle(a, b, c, Point<T>(origin + 1, origin + S - 1)) > 0);
+    CHECK(G::inCircle(a, b, c, Point<T>(origin - 1, origin + S + 1)) < 0);
+    CHECK(G::inCircle<G::ExactKernel>(a, b, c, Point<T>(origin + 1, origin + S - 1)) > 0);
+}
+
+} // namespace
+
+int main() {
+    for (uint32_t seed = 1; seed <= 5; ++seed) {
+        check(uniform<double>(1500, 0, 1, seed));
+        check(uniform<float>(1500, 0, 1, seed));
+        check(uniform<double>(1500, 0, 1000, seed));
+        check(uniform<int>(1500, -1e6, 1e6, seed));
+        check(uniform<long long>(1500, -1e6, 1e6, seed));
+        check(uniform<long long>(1500, -1e17, 1e17, seed));
+    }
+    std::vector<Point<long long>> wide;
+    for (long long x = 0; x < 30; ++x)
+        for (long long y = 0; y < 30; ++y) wide.push_back(Point<long long>(x << 40, -(y << 40)));
+    check(wide);
+    checkInCircle<long long>(0);
+    checkInCircle<long long>(3000000000000000000LL);
+    checkInCircle<long long>(-3000000000000000000LL);
+    checkInCircle<double>(0);
+    checkInCircle<double>(1 << 20);
+
+    // Cocircular lattice points: every in-circle test of a square is a tie.
+    std::vector<Point<int>> grid;
+    for (int x = 0; x < 30; ++x)
+        for (int y = 0; y < 30; ++y) grid.push_back(Point<int>(x, y));
+    check(grid);
+
+    return checkResult("delaunay");
+}
@@ -0,0 +1,101 @@
+// Applies random inserts, moves and erases to EditablePolygon and checks,
+// after every edit, the incrementally kept area, bounding box and containment
+// against polygonSignedArea, boundingBox and isInside on vertices(). Each run
+// also erases the polygon down to nothing and builds it up again.
+//
+// Build and run from the repository root (add -fsanitize=address,undefined
+// to catch reads past the ring):
+//
+//   g++ -std=c++17 -O2 tests/editable_polygon_test.cxx -lpthread -o editable_polygon_test && ./editable_polygon_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+void checkAgainstScratch(const G::EditablePolygon<T>& poly, std::mt19937& rng) {
+    std::vector<Point<T>> v = poly.vertices();
+    CHECK(v.size() == poly.size());
+    long double expected = v.empty() ? 0 : (long double)G::polygonSignedArea(v);
+    long double tolerance = std::is_floating_point<T>::value ? 1e-6L * (1 + std::abs(expected)) : 0;
+    CHECK(std::abs((long double)poly.signedArea() - expected) <= tolerance);
+
+    G::BoundingBox<T> box = G::boundingBox(v), kept = poly.bounds();
+    CHECK(kept.min == box.min && kept.max == box.max);
+
+    std::uniform_real_distribution<double> uni(-120, 120);
+    for (int q = 0; q < 8; ++q) {
+        Point<T> p((T)uni(rng), (T)uni(rng));
+        bool inside = v.size() >= 3 && G::isInside(v, p);
+        CHECK(poly.contains(p) == inside);
+    }
+}
+
+template <typename T>
+void run(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> jitter(-3, 3);
+
+    // A star-shaped outline, so small radial edits keep it simple.
+    std::vector<Point<T>> outline;
+    const int n = 200;
+    for (int i = 0; i < n; ++i) {
+        double t = 2 * M_PI * i / n, r = 80 + 10 * std::sin(5 * t);
+        outline.push_back(Point<T>((T)(r * std::cos(t)), (T)(r * std::sin(t))));
+    }
+    G::EditablePolygon<T> poly(outline);
+    checkAgainstScratch(poly, rng);
+
+    std::vector<size_t> ids;
+    for (int i = 0; i < n; ++i) ids.push_back(i);
+    for (int step = 0; step < 2000; ++step) {
+        size_t k = rng() % ids.size(), v = ids[k];
+        Point<T> p = poly.point(v);
+        switch (rng() % 3) {
+        case 0: {
+            Point<T> q = poly.point(poly.next(v));
+            Point<T> mid((T)((p.x + q.x) / 2 + jitter(rng) / 4), (T)((p.y + q.y) / 2 + jitter(rng) / 4));
+            ids.push_back(poly.insertAfter(v, mid));
+            break;
+        }
+        case 1:
+            poly.move(v, Point<T>((T)(p.x * (1 + jitter(rng) / 400)), (T)(p.y * (1 + jitter(rng) / 400))));
+            break;
+        default:
+            if (ids.size() <= 4) break;
+            poly.erase(v);
+            ids[k] = ids.back();
+            ids.pop_back();
+        }
+        if (step % 10 == 0) checkAgainstScratch(poly, rng);
+    }
+
+    // Down to nothing, then back up from an empty ring.
+    while (!poly.empty()) {
+        poly.erase(poly.first());
+        checkAgainstScratch(poly, rng);
+    }
+    size_t v = poly.insertAfter(G::EditablePolygon<T>::None, Point<T>(0, 0));
+    v = poly.insertAfter(v, Point<T>(50, 0));
+    poly.insertAfter(v, Point<T>(0, 50));
+    checkAgainstScratch(poly, rng);
+}
+
+} // namespace
+
+int main() {
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        run<double>(seed);
+        run<float>(seed);
+        run<int>(seed);
+        run<long long>(seed);
+    }
+    return checkResult("editable polygon");
+}
@@ -0,0 +1,203 @@
+// Writes point files and reads them back through MappedFile and PointFile,
+// including after moving the mapping to another object; feeds PointFile
+// truncated files and corrupted headers and CSR offsets, each of which must
+// fail to open; and round-trips points through the text format.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/point_file_test.cxx -lpthread -o point_file_test && ./point_file_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+// A fresh empty file under /tmp, removed by the destructor.
+struct TempFile {
+    char path[32] = "/tmp/cg2d_test_XXXXXX";
+    TempFile() { ::close(::mkstemp(path)); }
+    ~TempFile() { std::remove(path); }
+};
+
+void writeBytes(const char* path, const std::string& bytes) {
+    std::FILE* f = std::fopen(path, "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), f);
+    std::fclose(f);
+}
+
+std::string readBytes(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    std::string bytes;
+    char buf[4096];
+    for (size_t got; (got = std::fread(buf, 1, sizeof(buf), f)) > 0;) bytes.append(buf, got);
+    std::fclose(f);
+    return bytes;
+}
+
+template <typename T>
+bool opens(const std::string& bytes) {
+    TempFile tmp;
+    writeBytes(tmp.path, bytes);
+    G::PointFile<T> file(tmp.path);
+    if (!file.valid()) CHECK(file.size() == 0 && file.points() == nullptr && file.offsets() == nullptr);
+    return file.valid();
+}
+
+template <typename T>
+std::string patched(std::string bytes, size_t at, uint64_t value) {
+    std::memcpy(&bytes[at], &value, sizeof(value));
+    return bytes;
+}
+
+void checkValidation() {
+    std::vector<Point<int>> vertices;
+    std::vector<size_t> offsets{0};
+    for (int k = 0; k < 5; ++k) {
+        for (int i = 0; i <= k + 2; ++i) vertices.push_back(Point<int>(10 * k + i, i * i));
+        offsets.push_back(vertices.size());
+    }
+    TempFile tmp;
+    CHECK(G::writePolygons(tmp.path, vertices, offsets));
+    G::PointFile<int> file(tmp.path);
+    CHECK(file.valid() && file.size() == vertices.size() && file.polygonCount() == 5);
+    if (file.valid()) {
+        CHECK(std::equal(vertices.begin(), vertices.end(), file.points()));
+        CHECK(std::equal(offsets.begin(), offsets.end(), file.offsets()));
+        CHECK(file.polygonSize(4) == 7 && file.polygon(4)[0] == vertices[offsets[4]]);
+        G::BoundingBox<int> box = file.boundingBox(), expected = G::boundingBox(vertices);
+        CHECK(box.min == expected.min && box.max == expected.max);
+    }
+    const std::string bytes = readBytes(tmp.path);
+    CHECK(opens<int>(bytes));
+
+    // Wrong coordinate type, missing file.
+    CHECK(!opens<float>(bytes) && !opens<long long>(bytes));
+    CHECK(!G::PointFile<int>("/nonexistent/cg2d").valid());
+
+    // Truncated anywhere: inside the header, the points or the offsets.
+    const size_t header = sizeof(G::PointFileHeader), offsetsAt = bytes.size() - 6 * 8;
+    for (size_t cut : {size_t(0), size_t(7), header - 1, header + 4, offsetsAt - 1, offsetsAt + 8, bytes.size() - 1})
+        CHECK(!opens<int>(bytes.substr(0, cut)));
+
+    // Header fields: magic, version, counts.
+    std::string bad = bytes;
+    bad[0] = 'X';
+    CHECK(!opens<int>(bad));
+    CHECK(!opens<int>(patched<int>(bytes, 8, 2)));                            // version (and type, zeroed)
+    CHECK(!opens<int>(patched<int>(bytes, 16, vertices.size() + 1)));         // count
+    CHECK(!opens<int>(patched<int>(bytes, 16, ~uint64_t(0) / 8)));            // count * 8 overflows
+    CHECK(!opens<int>(patched<int>(bytes, 24, 6)));                           // polygons
+    CHECK(!opens<int>(patched<int>(bytes, 24, ~uint64_t(0))));                // polygons + 1 overflows
+
+    // CSR offsets: first not 0, last not count, decreasing.
+    CHECK(!opens<int>(patched<int>(bytes, offsetsAt, 1)));
+    CHECK(!opens<int>(patched<int>(bytes, bytes.size() - 8, vertices.size() - 1)));
+    CHECK(!opens<int>(patched<int>(bytes, offsetsAt + 2 * 8, offsets[3] + 1)));
+    CHECK(!opens<int>(patched<int>(bytes, offsetsAt + 8, ~uint64_t(0))));
+
+    // A plain point set has no offsets; an empty one is still valid.
+    TempFile plain;
+    CHECK(G::writePoints(plain.path, std::vector<Point<double>>()));
+    G::PointFile<double> none(plain.path);
+    CHECK(none.valid() && none.size() == 0 && none.polygonCount() == 0 && none.offsets() == nullptr);
+}
+
+template <typename T>
+bool sameBits(const std::vector<Point<T>>& a, const std::vector<Point<T>>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Point<T>)) == 0;
+}
+
+template <typename T>
+void checkTextRoundTrip() {
+    std::mt19937_64 rng(17);
+    std::vector<Point<T>> pts = {Point<T>(0, 1), Point<T>(std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()),
+                                 Point<T>(std::numeric_limits<T>::min(), -1)};
+    if constexpr (std::is_floating_point<T>::value) {
+        pts.push_back(Point<T>(std::numeric_limits<T>::denorm_min(), (T)-0.0));
+        std::uniform_real_distribution<T> uni(-1e6, 1e6);
+        for (int i = 0; i < 5000; ++i) pts.push_back(Point<T>(uni(rng), std::ldexp(uni(rng), (int)(rng() % 200) - 100)));
+    } else {
+        for (int i = 0; i < 5000; ++i) pts.push_back(Point<T>((T)rng(), (T)rng()));
+    }
+
+    std::string text;
+    G::formatPoints(pts, text);
+    std::vector<Point<T>> back;
+    CHECK(G::parsePoints(text, back));
+    CHECK(sameBits(back, pts));
+
+    TempFile tmp;
+    CHECK(G::writePointsText(tmp.path, pts));
+    back.clear();
+    CHECK(G::readPointsText(tmp.path, back));
+    CHECK(sameBits(back, pts));
+}
+
+void checkParsing() {
+    std::vector<Point<double>> out;
+    CHECK(G::parsePoints(std::string("+5 3\n+.5,-2\r\n1\t+0.25"), out));
+    CHECK(out.size() == 3 && out[0] == Point<double>(5, 3) && out[1] == Point<double>(0.5, -2) && out[2] == Point<double>(1, 0.25));
+    out.clear();
+    CHECK(G::parsePoints(std::string(" \n, "), out) && out.empty());
+    for (const char* bad : {"+-5 3", "++5 3", "+ 5 3", "5 +", "- 5 3", "1 2 3", "1x 2", "1 2,,3 4 5", "+"})
+        CHECK(!G::parsePoints(std::string(bad), out));
+
+    std::vector<Point<int>> ints;
+    CHECK(G::parsePoints(std::string("+7 -8"), ints) && ints.size() == 1 && ints[0] == Point<int>(7, -8));
+    CHECK(!G::parsePoints(std::string("+-7 8"), ints) && !G::parsePoints(std::string("1.5 2"), ints));
+    CHECK(!G::parsePoints(std::string("99999999999 1"), ints)); // out of range
+}
+
+void checkMoves() {
+    TempFile tmp;
+    writeBytes(tmp.path, "hello");
+
+    G::MappedFile a(tmp.path);
+    CHECK(a.valid() && a.size() == 5);
+    G::MappedFile b(std::move(a));
+    CHECK(b.valid() && b.size() == 5 && std::memcmp(b.data(), "hello", 5) == 0);
+    CHECK(!a.valid() && a.size() == 0 && a.data() == nullptr);
+
+    G::MappedFile c;
+    c = std::move(b);
+    CHECK(c.valid() && c.size() == 5 && std::memcmp(c.data(), "hello", 5) == 0);
+    CHECK(!b.valid() && b.size() == 0 && b.data() == nullptr);
+
+    // Assigning over a live mapping releases it.
+    G::MappedFile d(tmp.path);
+    d = std::move(c);
+    CHECK(d.valid() && d.size() == 5 && !c.valid());
+
+    // An empty file is a valid, zero-length mapping, and stays one when moved.
+    TempFile none;
+    G::MappedFile e(none.path);
+    CHECK(e.valid() && e.size() == 0);
+    G::MappedFile f(std::move(e));
+    CHECK(f.valid() && !e.valid());
+
+    std::vector<Point<double>> pts = {Point<double>(1, 2), Point<double>(3, 4)};
+    TempFile points;
+    CHECK(G::writePoints(points.path, pts));
+    G::PointFile<double> file(points.path);
+    G::PointFile<double> moved(std::move(file));
+    CHECK(moved.valid() && moved.size() == 2 && moved.points()[1] == pts[1]);
+}
+
+} // namespace
+
+int main() {
+    checkMoves();
+    checkValidation();
+    checkParsing();
+    checkTextRoundTrip<double>();
+    checkTextRoundTrip<float>();
+    checkTextRoundTrip<int>();
+    checkTextRoundTrip<long long>();
+    return checkResult("point file");
+}
@@ -0,0 +1,109 @@
+// Checks sortPoints, sortPointsByY, their parallel forms and
+// spatialSortParallel against std::stable_sort and the serial spatialSort.
+// From RadixThreshold (1024 points) up the comparison is bit for bit: the
+// radix sorts are stable, fold -0.0 into +0.0 (so the two keep their input
+// order) and sort ties of 8-byte major keys by the minor coordinate. Below
+// it std::sort runs, and only the order of the keys is compared. Inputs are chosen to hit skipped digit passes (small integers,
+// clustered floats, all-equal keys), long runs of ties, and the per-task
+// scatter of the parallel forms with uneven blocks.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/point_sort_test.cxx -lpthread -o point_sort_test && ./point_sort_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+bool sameOrder(const std::vector<Point<T>>& a, const std::vector<Point<T>>& b) {
+    if (a.size() != b.size()) return false;
+    if (a.size() >= 1024) return std::memcmp(a.data(), b.data(), a.size() * sizeof(Point<T>)) == 0;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i] < b[i] || b[i] < a[i]) return false;
+    return true;
+}
+
+template <typename T>
+void check(const std::vector<Point<T>>& pts) {
+    std::vector<Point<T>> byX = pts, byY = pts;
+    std::stable_sort(byX.begin(), byX.end(), [](const Point<T>& a, const Point<T>& b) { return a < b; });
+    std::stable_sort(byY.begin(), byY.end(),
+                     [](const Point<T>& a, const Point<T>& b) { return a.y != b.y ? a.y < b.y : a.x < b.x; });
+
+    std::vector<Point<T>> v = pts;
+    G::sortPoints(v);
+    CHECK(sameOrder(v, byX));
+    v = pts;
+    G::sortPointsByY(v);
+    CHECK(sameOrder(v, byY));
+
+    G::Executor exec = G::threadExecutor(4);
+    for (size_t tasks : {2, 3, 4, 16}) {
+        v = pts;
+        G::sortPointsParallel(v, exec, tasks);
+        CHECK(sameOrder(v, byX));
+        v = pts;
+        G::sortPointsByYParallel(v, exec, tasks);
+        CHECK(sameOrder(v, byY));
+    }
+
+    std::vector<Point<T>> curve = pts, parallel = pts;
+    G::spatialSort(curve);
+    G::spatialSortParallel(parallel, G::SpaceCurve::Hilbert, exec, 3);
+    CHECK(sameOrder(curve, parallel));
+}
+
+template <typename T>
+void checkSizes(const std::function<Point<T>(std::mt19937_64&)>& gen) {
+    // Under the radix threshold, just over it, and past 2^16 per task.
+    for (size_t n : {size_t(100), size_t(1023), size_t(1024), size_t(5000), size_t(300001)}) {
+        std::mt19937_64 rng(n);
+        std::vector<Point<T>> pts(n);
+        for (auto& p : pts) p = gen(rng);
+        check(pts);
+    }
+}
+
+} // namespace
+
+int main() {
+    // Mixed signs and zeros of both signs, with few distinct x values so
+    // 8-byte major keys tie in long runs.
+    checkSizes<double>([](std::mt19937_64& rng) {
+        double zeros[] = {0.0, -0.0};
+        double x = rng() % 4 == 0 ? zeros[rng() % 2] : (double)((int)(rng() % 200) - 100) / 8;
+        double y = rng() % 4 == 0 ? zeros[rng() % 2] : std::ldexp((double)rng(), -60) - 8;
+        return Point<double>(x, y);
+    });
+    checkSizes<float>([](std::mt19937_64& rng) {
+        float zeros[] = {0.0f, -0.0f};
+        float x = rng() % 4 == 0 ? zeros[rng() % 2] : (float)((int)(rng() % 2000) - 1000) / 3;
+        return Point<float>(x, (float)((int)(rng() % 50) - 25));
+    });
+
+    // Clustered floats: the sign and exponent digits agree on every key.
+    checkSizes<double>([](std::mt19937_64& rng) {
+        return Point<double>(1.0 + std::ldexp((double)(rng() % 4096), -40), 1.0 + std::ldexp((double)(rng() % 16), -50));
+    });
+
+    // Small integers skip the high digit passes; negative ones exercise the
+    // sign flip; 8-byte ties fall back to the minor coordinate.
+    checkSizes<int>([](std::mt19937_64& rng) { return Point<int>((int)(rng() % 300), (int)(rng() % 300) - 150); });
+    checkSizes<int>([](std::mt19937_64& rng) { return Point<int>((int)rng(), (int)rng()); });
+    checkSizes<long long>([](std::mt19937_64& rng) { return Point<long long>((long long)(rng() % 64) - 32, (long long)rng()); });
+    checkSizes<long long>([](std::mt19937_64& rng) { return Point<long long>((long long)rng(), (long long)(rng() % 7)); });
+    checkSizes<unsigned>([](std::mt19937_64& rng) { return Point<unsigned>((unsigned)rng(), (unsigned)(rng() % 3)); });
+
+    // Every key equal: all passes are skipped and the input order stays.
+    checkSizes<double>([](std::mt19937_64& rng) { return Point<double>(rng() % 2 ? 0.0 : -0.0, 2.5); });
+
+    return checkResult("point sort");
+}
@@ -0,0 +1,98 @@
+// Saves and loads a PolygonIndex, then feeds load() truncated and corrupted
+// copies of the stream: each must return false and leave an empty index,
+// without throwing or allocating what a corrupt count asks for. A corrupt but
+// consistent box must load into an index whose queries stay defined; run
+// under -fsanitize=undefined for that.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/polygon_index_test.cxx -lpthread -o polygon_index_test && ./polygon_index_test
+
+#include <random>
+#include <sstream>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+bool loads(const std::string& bytes, G::PolygonIndex<double>& index) {
+    std::istringstream is(bytes);
+    try {
+        return index.load(is);
+    } catch (...) {
+        CHECK(!"load() threw");
+        return false;
+    }
+}
+
+} // namespace
+
+int main() {
+    std::vector<Point<double>> polygon;
+    for (int i = 0; i < 500; ++i) {
+        double t = 2 * M_PI * i / 500, r = 10 + 3 * std::sin(7 * t);
+        polygon.push_back(Point<double>(r * std::cos(t), r * std::sin(t)));
+    }
+    G::PolygonIndex<double> index(polygon);
+    std::ostringstream os;
+    index.save(os);
+    const std::string bytes = os.str();
+
+    G::PolygonIndex<double> loaded;
+    CHECK(loads(bytes, loaded));
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> uni(-15, 15);
+    for (int q = 0; q < 1000; ++q) {
+        Point<double> p(uni(rng), uni(rng));
+        CHECK(loaded.contains(p) == G::isInside(polygon, p));
+    }
+
+    // The band and edge counts follow the fixed-size header and the box: an
+    // empty index's stream ends with them and its one band start.
+    std::ostringstream empty;
+    G::PolygonIndex<double>().save(empty);
+    const size_t countsAt = empty.str().size() - 16 - 8;
+    const size_t boxAt = countsAt - sizeof(G::BoundingBox<double>);
+    auto patched = [&](size_t at, auto value) {
+        std::string b = bytes;
+        std::memcpy(&b[at], &value, sizeof(value));
+        return b;
+    };
+    const uint64_t Huge[] = {0, 1ull << 60, std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max() - 1};
+    for (uint64_t v : Huge) {
+        CHECK(!loads(patched(countsAt, v), loaded));
+        CHECK(loaded.bandCount() == 0 && !loaded.contains(Point<double>(0, 0)));
+        CHECK(!loads(patched(countsAt + 8, v), loaded));
+    }
+    for (size_t cut : {size_t(0), size_t(10), countsAt + 4, countsAt + 20, bytes.size() - 1})
+        CHECK(!loads(bytes.substr(0, cut), loaded));
+
+    // The band scale is derived from the box, so a corrupt box is what could
+    // send band() out of range: non-finite or inverted boxes are rejected.
+    const double minY = index.bounds().min.y, maxY = index.bounds().max.y;
+    const size_t minYAt = boxAt + sizeof(double), maxYAt = boxAt + 3 * sizeof(double);
+    for (double v : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(),
+                     -std::numeric_limits<double>::infinity()}) {
+        CHECK(!loads(patched(minYAt, v), loaded));
+        CHECK(!loads(patched(maxYAt, v), loaded));
+        CHECK(!loads(patched(boxAt, v), loaded));
+    }
+    CHECK(!loads(patched(minYAt, maxY + 1), loaded));
+    CHECK(!loads(patched(maxYAt, minY - 1), loaded));
+    CHECK(loaded.bandCount() == 0);
+
+    // Consistent but wrong: a sliver or a huge box scales every query far
+    // past the last band, or to nothing.
+    for (double v : {minY + 1e-300, 1e300}) {
+        CHECK(loads(patched(maxYAt, v), loaded));
+        for (int q = 0; q < 100; ++q) loaded.contains(Point<double>(uni(rng), uni(rng)));
+        loaded.contains(Point<double>(0, std::numeric_limits<double>::quiet_NaN()));
+    }
+
+    return checkResult("polygon index");
+}
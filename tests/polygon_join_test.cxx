@@ -0,0 +1,85 @@
+// Checks PolygonJoin against a brute-force scan: for every query point, the
+// lowest id of a polygon whose isInside accepts it, or None. Polygons overlap,
+// vary in size and include degenerate ones, and queries include every vertex
+// and edge midpoint as well as points outside all boxes.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/polygon_join_test.cxx -lpthread -o polygon_join_test && ./polygon_join_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+void run(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uni(0, 1000), size(2, 60), noise(0.6, 1.0);
+
+    std::vector<Point<T>> vertices;
+    std::vector<size_t> offsets{0};
+    for (int k = 0; k < 400; ++k) {
+        double cx = uni(rng), cy = uni(rng), r = size(rng);
+        int n = k % 50 == 0 ? 2 : 3 + (int)(rng() % 20); // every 50th polygon is degenerate
+        for (int i = 0; i < n; ++i) {
+            double t = 2 * M_PI * i / n, s = r * noise(rng);
+            vertices.push_back(Point<T>((T)(cx + s * std::cos(t)), (T)(cy + s * std::sin(t))));
+        }
+        offsets.push_back(vertices.size());
+    }
+
+    std::vector<Point<T>> queries;
+    std::uniform_real_distribution<double> wide(-100, 1100);
+    for (int i = 0; i < 20000; ++i) queries.push_back(Point<T>((T)wide(rng), (T)wide(rng)));
+    for (size_t p = 0; p + 1 < offsets.size(); ++p) {
+        for (size_t i = offsets[p]; i < offsets[p + 1]; ++i) {
+            const Point<T>& a = vertices[i];
+            const Point<T>& b = vertices[i + 1 < offsets[p + 1] ? i + 1 : offsets[p]];
+            queries.push_back(a);
+            queries.push_back(Point<T>((T)((a.x + b.x) / 2), (T)((a.y + b.y) / 2)));
+        }
+    }
+
+    std::vector<uint32_t> expected(queries.size(), G::PolygonJoin<T>::None);
+    for (size_t q = 0; q < queries.size(); ++q) {
+        for (size_t p = 0; p + 1 < offsets.size(); ++p) {
+            size_t n = offsets[p + 1] - offsets[p];
+            if (n >= 3 && G::isInside(vertices.data() + offsets[p], n, queries[q])) {
+                expected[q] = (uint32_t)p;
+                break;
+            }
+        }
+    }
+
+    for (double cellsPerPolygon : {0.1, 2.0, 16.0}) {
+        G::PolygonJoin<T> join(vertices, offsets, G::Executor(), cellsPerPolygon);
+        size_t wrong = 0;
+        for (size_t q = 0; q < queries.size(); ++q) wrong += join.locate(queries[q]) != expected[q];
+        CHECK(wrong == 0);
+
+        std::vector<uint32_t> out;
+        join.join(queries, out, G::threadExecutor(4));
+        CHECK(out == expected);
+    }
+
+    G::PolygonJoin<T> none(vertices.data(), offsets.data(), 0);
+    CHECK(none.locate(queries[0]) == G::PolygonJoin<T>::None);
+}
+
+} // namespace
+
+int main() {
+    for (uint32_t seed = 1; seed <= 3; ++seed) {
+        run<double>(seed);
+        run<float>(seed);
+        run<int>(seed);
+    }
+    return checkResult("polygon join");
+}
@@ -0,0 +1,94 @@
+// Instantiates every overload that takes a scratch object (HullScratch,
+// ClosestPairScratch, ClipScratch, TriangulationScratch) for each coordinate
+// type, with the scratch on a std::pmr arena, and checks each against the
+// allocating overload. A signature change that breaks one of them fails to
+// compile here.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/scratch_overloads_test.cxx -lpthread -o scratch_overloads_test && ./scratch_overloads_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+template <typename T>
+std::vector<Point<T>> randomPoints(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uni(-1000, 1000);
+    std::vector<Point<T>> pts(n);
+    for (auto& p : pts) p = Point<T>((T)uni(rng), (T)uni(rng));
+    return pts;
+}
+
+template <typename T>
+void run() {
+    char arena[1 << 16];
+    std::pmr::monotonic_buffer_resource mr(arena, sizeof arena);
+    std::vector<Point<T>> pts = randomPoints<T>(2000, 7);
+
+    G::HullScratch<T> hull(&mr);
+    std::vector<Point<T>> copy = pts;
+    std::vector<Point<T>> expected = G::convexHull(copy);
+    CHECK(G::convexHull(pts, hull) == expected);
+    std::pmr::vector<Point<T>> pmrHull(&mr);
+    G::convexHull(pts.data(), pts.size(), hull, std::back_inserter(pmrHull));
+    CHECK(std::equal(pmrHull.begin(), pmrHull.end(), expected.begin(), expected.end()));
+
+    copy = pts;
+    long double diameter = G::polygonDiameter(copy);
+    CHECK(G::polygonDiameter(pts, hull) == diameter);
+    CHECK(G::polygonDiameter(pts.data(), pts.size(), hull) == diameter);
+    G::CalipersResult<T> calipers = G::rotatingCalipers(pts.data(), pts.size(), hull);
+    CHECK(calipers.diameter == G::rotatingCalipers(expected).diameter);
+    CHECK(calipers.width == G::minimumWidth(expected));
+
+    G::ClosestPairScratch<T> pair(&mr);
+    long double closest = G::closestPair(pts);
+    CHECK(G::closestPair(pts, pair) == closest);
+    CHECK(G::findClosestPair(pts, pair).distance == closest);
+    CHECK(G::findClosestPair(pts.data(), pts.size(), pair).distance == closest);
+    CHECK(G::findClosestPairParallel(pts.data(), pts.size(), pair, G::threadExecutor(2), 2).distance == closest);
+
+    std::vector<Point<T>> square = {Point<T>(0, 0), Point<T>(100, 0), Point<T>(100, 100), Point<T>(0, 100)};
+    std::vector<Point<T>> diamond = {Point<T>(50, -20), Point<T>(120, 50), Point<T>(50, 120), Point<T>(-20, 50)};
+    G::ClipScratch<T> clip(&mr);
+    std::pmr::vector<Point<T>> clipped(&mr);
+    G::BoundingBox<T> box{Point<T>(10, 10), Point<T>(60, 60)};
+    G::clipRect(diamond, box, clipped, clip);
+    std::vector<Point<T>> rect = G::clipRect(diamond, box);
+    CHECK(std::equal(clipped.begin(), clipped.end(), rect.begin(), rect.end()));
+    G::clipConvex(diamond, square, clipped, clip);
+    std::vector<Point<T>> convex = G::clipConvex(diamond, square);
+    CHECK(std::equal(clipped.begin(), clipped.end(), convex.begin(), convex.end()));
+    std::vector<std::vector<Point<T>>> rings;
+    CHECK(G::polygonBoolean(square, diamond, G::BooleanOp::Union, rings, clip));
+    CHECK(rings == G::polygonBoolean(square, diamond, G::BooleanOp::Union));
+
+    G::TriangulationScratch<T> tri(&mr);
+    std::pmr::vector<uint32_t> indices(&mr);
+    std::vector<uint32_t> ear = G::triangulate(square);
+    CHECK(G::triangulate(square.data(), square.size(), indices, tri) == 2);
+    CHECK(std::equal(indices.begin(), indices.end(), ear.begin(), ear.end()));
+    indices.clear();
+    std::vector<uint32_t> monotone = G::triangulateMonotone(square);
+    CHECK(G::triangulateMonotone(square.data(), square.size(), indices, tri) == 2);
+    CHECK(std::equal(indices.begin(), indices.end(), monotone.begin(), monotone.end()));
+}
+
+} // namespace
+
+int main() {
+    run<int>();
+    run<long long>();
+    run<float>();
+    run<double>();
+    return checkResult("scratch overloads");
+}
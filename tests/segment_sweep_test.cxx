@@ -0,0 +1,115 @@
+// Checks segmentIntersections, countSegmentIntersections and
+// anySegmentsIntersect against an O(n^2) doIntersect loop. Integer grids give
+// collinear overlaps, shared endpoints, vertical and zero-length segments in
+// bulk; the hand-built sets isolate each of those cases.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/segment_sweep_test.cxx -lpthread -o segment_sweep_test && ./segment_sweep_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+template <typename T>
+using Segment = G::Segment<T>;
+using Pairs = std::vector<std::pair<size_t, size_t>>;
+
+template <typename T>
+Pairs bruteForce(const std::vector<Segment<T>>& segs) {
+    Pairs pairs;
+    for (size_t i = 0; i < segs.size(); ++i)
+        for (size_t j = i + 1; j < segs.size(); ++j)
+            if (G::doIntersect<G::ExactKernel>(segs[i].a, segs[i].b, segs[j].a, segs[j].b)) pairs.push_back({i, j});
+    return pairs;
+}
+
+template <typename T>
+void check(const std::vector<Segment<T>>& segs) {
+    Pairs expected = bruteForce(segs);
+    Pairs got = G::segmentIntersections(segs);
+    std::sort(got.begin(), got.end());
+    bool ordered = true;
+    for (auto [i, j] : got) ordered = ordered && i < j;
+    CHECK(ordered);
+    CHECK(got == expected);
+    CHECK(G::countSegmentIntersections(segs) == expected.size());
+    CHECK(G::anySegmentsIntersect(segs) == !expected.empty());
+}
+
+template <typename T>
+std::vector<Segment<T>> randomGrid(size_t n, int side, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Segment<T>> segs;
+    for (size_t i = 0; i < n; ++i) {
+        Point<T> a((T)(rng() % side), (T)(rng() % side)), b;
+        switch (rng() % 4) {
+        case 0: b = Point<T>(a.x, (T)(rng() % side)); break; // vertical
+        case 1: b = Point<T>((T)(rng() % side), a.y); break; // horizontal
+        default: b = Point<T>((T)(rng() % side), (T)(rng() % side));
+        }
+        segs.push_back(Segment<T>(a, b));
+    }
+    return segs;
+}
+
+} // namespace
+
+int main() {
+    // Collinear overlaps on one line, including nested and touching ones.
+    check(std::vector<Segment<int>>{{{0, 0}, {10, 0}}, {{5, 0}, {15, 0}}, {{2, 0}, {3, 0}}, {{15, 0}, {20, 0}}, {{21, 0}, {30, 0}}});
+    check(std::vector<Segment<int>>{{{0, 0}, {10, 10}}, {{5, 5}, {15, 15}}, {{12, 12}, {11, 11}}, {{16, 16}, {20, 20}}});
+
+    // Shared endpoints: a fan, and a polyline whose neighbours touch.
+    std::vector<Segment<int>> fan;
+    for (int k = 0; k < 12; ++k) fan.push_back(Segment<int>(Point<int>(0, 0), Point<int>(k % 3 == 0 ? -10 : 10, k - 6)));
+    check(fan);
+    std::vector<Segment<int>> polyline;
+    for (int k = 0; k < 20; ++k) polyline.push_back(Segment<int>(Point<int>(k, k % 2), Point<int>(k + 1, (k + 1) % 2)));
+    check(polyline);
+
+    // Vertical segments: a lattice of verticals and horizontals, stacked
+    // verticals on one x, and a vertical through another's endpoint.
+    std::vector<Segment<int>> lattice;
+    for (int k = 0; k < 8; ++k) {
+        lattice.push_back(Segment<int>(Point<int>(2 * k, 0), Point<int>(2 * k, 14)));
+        lattice.push_back(Segment<int>(Point<int>(-1, 2 * k), Point<int>(15, 2 * k)));
+    }
+    check(lattice);
+    check(std::vector<Segment<int>>{{{3, 0}, {3, 2}}, {{3, 2}, {3, 5}}, {{3, 6}, {3, 9}}, {{3, 4}, {3, 7}}, {{0, 4}, {3, 4}}, {{3, 9}, {6, 0}}});
+
+    // Zero-length segments on, at the end of and off other segments.
+    check(std::vector<Segment<int>>{{{0, 0}, {10, 0}}, {{5, 0}, {5, 0}}, {{10, 0}, {10, 0}}, {{5, 1}, {5, 1}}, {{5, 1}, {5, 1}}});
+
+    // No pairs at all.
+    check(std::vector<Segment<int>>{{{0, 0}, {1, 1}}, {{2, 0}, {3, 1}}, {{4, 0}, {5, 1}}});
+    check(std::vector<Segment<int>>{});
+
+    for (uint32_t seed = 1; seed <= 20; ++seed) {
+        check(randomGrid<int>(200, 8, seed));
+        check(randomGrid<int>(300, 30, seed));
+        check(randomGrid<long long>(300, 30, seed));
+        check(randomGrid<double>(200, 12, seed));
+    }
+
+    // General position doubles: crossings are located in long double, but
+    // none are near-misses at this density.
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> uni(0, 1000), len(-60, 60);
+    for (int it = 0; it < 5; ++it) {
+        std::vector<Segment<double>> segs;
+        for (int i = 0; i < 800; ++i) {
+            Point<double> a(uni(rng), uni(rng));
+            segs.push_back(Segment<double>(a, Point<double>(a.x + len(rng), a.y + len(rng))));
+        }
+        check(segs);
+    }
+
+    return checkResult("segment sweep");
+}
@@ -0,0 +1,138 @@
+// Checks triangulate, triangulateMonotone and triangulateBatch on simple
+// polygons: every triangle is counter-clockwise, indices stay in range, the
+// triangle areas add up to the polygon's area and the count is n - 2 less the
+// dropped collinear vertices. Random self-intersecting input must come back
+// with in-range indices and no crash; run under -fsanitize=address,undefined
+// for the stated guarantee.
+//
+// Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 tests/triangulation_test.cxx -lpthread -o triangulation_test && ./triangulation_test
+
+#include <random>
+
+#include "../comp_geom_2D.cxx"
+#include "check.h"
+
+namespace {
+
+using G = comp_geom_2D;
+template <typename T>
+using Point = G::Point<T>;
+
+// Triangles of indices[from, to) against the polygon vertices[base, base + n).
+template <typename T>
+void checkTiling(const std::vector<Point<T>>& vertices, size_t base, size_t n, const std::vector<uint32_t>& indices,
+                 size_t from, size_t to, size_t expectedTriangles) {
+    CHECK((to - from) % 3 == 0);
+    CHECK((to - from) / 3 == expectedTriangles);
+    long double area = 0;
+    bool inRange = true, ccw = true;
+    for (size_t k = from; k + 2 < to; k += 3) {
+        for (size_t j = k; j < k + 3; ++j) inRange = inRange && indices[j] >= base && indices[j] < base + n;
+        if (!inRange) break;
+        const Point<T>& a = vertices[indices[k]], & b = vertices[indices[k + 1]], & c = vertices[indices[k + 2]];
+        long double cross = ((long double)b.x - a.x) * ((long double)c.y - a.y) - ((long double)b.y - a.y) * ((long double)c.x - a.x);
+        ccw = ccw && cross >= 0;
+        area += cross / 2;
+    }
+    CHECK(inRange);
+    CHECK(ccw);
+    long double expected = std::abs((long double)G::polygonSignedArea(vertices.data() + base, n));
+    CHECK(std::abs(area - expected) <= 1e-9L * expected);
+}
+
+template <typename T>
+void checkBoth(const std::vector<Point<T>>& polygon, size_t expectedTriangles) {
+    std::vector<uint32_t> ear = G::triangulate<G::ExactKernel>(polygon);
+    checkTiling(polygon, 0, polygon.size(), ear, 0, ear.size(), expectedTriangles);
+    std::vector<uint32_t> monotone = G::triangulateMonotone<G::ExactKernel>(polygon);
+    checkTiling(polygon, 0, polygon.size(), monotone, 0, monotone.size(), expectedTriangles);
+}
+
+// Random radii around the origin: star-shaped, so simple, and mostly
+// reflex vertices; large n takes the z-order indexed ear test.
+std::vector<Point<double>> star(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> radius(0.3, 1.0);
+    std::vector<Point<double>> p;
+    for (size_t i = 0; i < n; ++i) {
+        double t = 2 * M_PI * i / n, r = radius(rng);
+        p.push_back(Point<double>(r * std::cos(t), r * std::sin(t)));
+    }
+    return p;
+}
+
+} // namespace
+
+int main() {
+    std::vector<Point<int>> square = {Point<int>(0, 0), Point<int>(4, 0), Point<int>(4, 4), Point<int>(0, 4)};
+    checkBoth(square, 2);
+    checkBoth(std::vector<Point<int>>(square.rbegin(), square.rend()), 2);
+
+    // A comb: long reflex runs for the monotone sweep's merge vertices.
+    std::vector<Point<int>> comb;
+    for (int i = 0; i < 10; ++i) {
+        comb.push_back(Point<int>(4 * i, 10));
+        comb.push_back(Point<int>(4 * i + 2, 0));
+    }
+    comb.push_back(Point<int>(40, 10));
+    comb.push_back(Point<int>(40, 20));
+    comb.push_back(Point<int>(0, 20));
+    std::reverse(comb.begin(), comb.end());
+    checkBoth(comb, comb.size() - 2);
+
+    // A collinear vertex and a repeated one are dropped.
+    std::vector<Point<int>> flat = {Point<int>(0, 0), Point<int>(2, 0), Point<int>(4, 0), Point<int>(4, 4), Point<int>(4, 4),
+                                    Point<int>(0, 4)};
+    checkBoth(flat, 2);
+
+    for (size_t n : {10, 100, 1000, 20000})
+        for (uint32_t seed = 1; seed <= 3; ++seed) checkBoth(star(n, seed), n - 2);
+
+    // A spiral corridor: long, narrow and winding.
+    std::vector<Point<double>> spiral;
+    for (int i = 0; i < 3000; ++i) spiral.push_back(Point<double>((1 + i * 0.01) * std::cos(i * 0.01), (1 + i * 0.01) * std::sin(i * 0.01)));
+    for (int i = 2999; i >= 0; --i)
+        spiral.push_back(Point<double>((1.5 + i * 0.01) * std::cos(i * 0.01), (1.5 + i * 0.01) * std::sin(i * 0.01)));
+    checkBoth(spiral, spiral.size() - 2);
+
+    // Batches: indices address the flat vertex array, per-polygon ranges
+    // follow indexOffsets, for both methods and with an executor.
+    std::vector<Point<double>> vertices;
+    std::vector<size_t> offsets{0};
+    for (uint32_t k = 0; k < 300; ++k) {
+        std::vector<Point<double>> p = star(30 + k, k);
+        vertices.insert(vertices.end(), p.begin(), p.end());
+        offsets.push_back(vertices.size());
+    }
+    for (auto method : {G::TriangulationMethod::EarClipping, G::TriangulationMethod::Monotone}) {
+        std::vector<uint32_t> indices;
+        std::vector<size_t> indexOffsets;
+        G::triangulateBatch<G::ExactKernel>(vertices, offsets, indices, indexOffsets, method, G::threadExecutor(4));
+        CHECK(indexOffsets.size() == offsets.size() && indexOffsets.back() == indices.size());
+        for (size_t k = 0; k + 1 < offsets.size(); ++k)
+            checkTiling(vertices, offsets[k], offsets[k + 1] - offsets[k], indices, indexOffsets[k], indexOffsets[k + 1],
+                        offsets[k + 1] - offsets[k] - 2);
+    }
+
+    // Random, mostly self-intersecting polygons: only the index range is
+    // promised, plus no crash or hang.
+    std::mt19937 rng(11);
+    G::TriangulationScratch<int> scratch;
+    for (int it = 0; it < 3000; ++it) {
+        size_t n = 3 + rng() % 200;
+        std::vector<Point<int>> p;
+        for (size_t i = 0; i < n; ++i) p.push_back(Point<int>(rng() % 100, rng() % 100));
+        std::vector<uint32_t> indices;
+        G::triangulate(p.data(), n, indices, scratch, 7);
+        G::triangulateMonotone(p.data(), n, indices, scratch, 7);
+        bool inRange = indices.size() % 3 == 0;
+        for (uint32_t v : indices) inRange = inRange && v >= 7 && v < 7 + n;
+        CHECK(inRange);
+    }
+    std::vector<Point<double>> none;
+    CHECK(G::triangulate(none).empty() && G::triangulateMonotone(none).empty());
+
+    return checkResult("triangulation");
+}